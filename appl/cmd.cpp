@@ -36,11 +36,13 @@ void printUsage()
 {
     SWSS_LOG_ENTER();
 
-    std::cout << "Usage: cmd [set|get|state]" << std::endl;
+    std::cout << "Usage: cmd [set|get|state|diag|latency]" << std::endl;
     std::cout << "    cmd set <TABLE> <KEY> <FIELD>=<VALUE>" << std::endl;
     std::cout << "    cmd get <TABLE> <KEY> <FIELD>" << std::endl;
     std::cout << "" << std::endl;
     std::cout << "    cmd state" << std::endl;
+    std::cout << "    cmd diag <scheduler|attr-sets|notifications|flex-counters|presence|connections|retries|warm-restart|otai-api|otai-slow>" << std::endl;
+    std::cout << "    cmd latency [slow [threshold_ms]]" << std::endl;
 }
 
 typedef bool (*cmd_func_t)(int argc, char **argv);
@@ -55,11 +57,15 @@ typedef struct cmd_s
 bool cmd_set(int argc, char **argv);
 bool cmd_get(int argc, char **argv);
 bool cmd_state(int argc, char **argv);
+bool cmd_diag(int argc, char **argv);
+bool cmd_latency(int argc, char **argv);
 
 cmd_t cmd_list[] = {
     {"set", cmd_set}, 
     {"get", cmd_get},
     {"state", cmd_state},
+    {"diag", cmd_diag},
+    {"latency", cmd_latency},
 };
 
 int cmd_cnt = COUNTOF(cmd_list);
@@ -270,6 +276,79 @@ bool cmd_state(int argc, char **argv)
     return false;
 }
 
+/* Send a query to DiagOrch and print the fields of its reply */
+bool diag_query(const string &op, std::vector<swss::FieldValueTuple> &values)
+{
+    swss::DBConnector db("APPL_DB", 0);
+    swss::NotificationProducer query(&db, "SWSS_DIAG_CHANNEL");
+    swss::NotificationConsumer reply(&db, "SWSS_DIAG_REPLY");
+
+    swss::Select s;
+    s.addSelectable(&reply);
+    swss::Selectable *sel;
+
+    query.send(op, op, values);
+
+    std::string op_ret, data;
+    std::vector<swss::FieldValueTuple> values_ret;
+    int wait_time = 15000;
+    int result = s.select(&sel, wait_time);
+    if (result == swss::Select::OBJECT) {
+        reply.pop(op_ret, data, values_ret);
+        if (op_ret == "SUCCESS") {
+            for (auto v: values_ret) {
+                std::cout << std::get<0>(v) << ": " << std::get<1>(v) << std::endl;
+            }
+            return true;
+        } else {
+            SWSS_LOG_NOTICE("command exec failed, op_ret %s status %s", op_ret.c_str(), data.c_str());
+        }
+    } else if (result == swss::Select::TIMEOUT) {
+        SWSS_LOG_NOTICE("command exec failed for %s timed out", op.c_str());
+    } else {
+        SWSS_LOG_NOTICE("command exec failed for %s error", op.c_str());
+    }
+    values_ret.clear();
+
+    return false;
+}
+
+bool cmd_diag(int argc, char **argv)
+{
+    if (argc != 2)
+    {
+        printUsage();
+        exit(EXIT_FAILURE);
+    }
+
+    std::vector<swss::FieldValueTuple> values;
+
+    return diag_query(argv[1], values);
+}
+
+bool cmd_latency(int argc, char **argv)
+{
+    std::vector<swss::FieldValueTuple> values;
+
+    if (argc == 1)
+    {
+        return diag_query("latency", values);
+    }
+
+    if (strcmp(argv[1], "slow") != 0 || argc > 3)
+    {
+        printUsage();
+        exit(EXIT_FAILURE);
+    }
+
+    if (argc == 3)
+    {
+        values.emplace_back("threshold-ms", argv[2]);
+    }
+
+    return diag_query("latency-slow", values);
+}
+
 int main(int argc, char **argv)
 {
     swss::Logger::getInstance().setMinPrio(swss::Logger::SWSS_INFO);
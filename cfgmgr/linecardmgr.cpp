@@ -24,6 +24,7 @@
 #include "linecardmgr.h"
 #include "exec.h"
 #include "shellcmd.h"
+#include "subscriberstatetable.h"
 
 using namespace std;
 using namespace swss;
@@ -34,6 +35,14 @@ LineCardMgr::LineCardMgr(DBConnector* cfgDb, DBConnector* appDb, DBConnector* st
     m_stateLineCardTable(stateDb, STATE_OT_LINECARD_TABLE_NAME),
     m_appLineCardTable(appDb, APP_OT_LINECARD_TABLE_NAME)
 {
+    /*
+     * The linecard state wakes up the SET tasks waiting for the power to be
+     * enabled, see doStateTask(). The table may have the same name as the
+     * config one, so its executor gets a name of its own.
+     */
+    auto stateTable = new SubscriberStateTable(stateDb, STATE_OT_LINECARD_TABLE_NAME,
+                                               TableConsumable::DEFAULT_POP_BATCH_SIZE, 0);
+    addExecutor(new Consumer(stateTable, this, string("STATE_") + STATE_OT_LINECARD_TABLE_NAME));
 }
 
 bool LineCardMgr::setLineCardAttr(const string& alias, std::vector<FieldValueTuple>& fvs)
@@ -65,10 +74,32 @@ bool LineCardMgr::isLineCardStateOk(const string& alias)
     return false;
 }
 
+void LineCardMgr::doStateTask(Consumer& consumer)
+{
+    SWSS_LOG_ENTER();
+
+    auto it = consumer.m_toSync.begin();
+
+    while (it != consumer.m_toSync.end())
+    {
+        string alias = kfvKey(it->second);
+
+        releaseRetries(string(STATE_OT_LINECARD_TABLE_NAME) + state_db_key_delimiter + alias);
+
+        it = consumer.m_toSync.erase(it);
+    }
+}
+
 void LineCardMgr::doTask(Consumer& consumer)
 {
     SWSS_LOG_ENTER();
 
+    if (consumer.getDbName() == "STATE_DB")
+    {
+        doStateTask(consumer);
+        return;
+    }
+
     auto it = consumer.m_toSync.begin();
 
     while (it != consumer.m_toSync.end())
@@ -84,7 +115,8 @@ void LineCardMgr::doTask(Consumer& consumer)
         {
             if (!isLineCardStateOk(alias))
             {
-                it++;
+                it = consumer.retryLater(it, "linecard power disabled",
+                                         string(STATE_OT_LINECARD_TABLE_NAME) + state_db_key_delimiter + alias);
                 continue;
             }
 
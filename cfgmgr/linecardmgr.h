@@ -22,6 +22,7 @@ namespace swss
         ProducerStateTable m_appLineCardTable;
 
         void doTask(Consumer& consumer);
+        void doStateTask(Consumer& consumer);
         bool setLineCardAttr(const std::string& alias, std::vector<FieldValueTuple>& fvs);
         bool isLineCardStateOk(const std::string& alias);
     };
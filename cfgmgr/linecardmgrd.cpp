@@ -73,6 +73,8 @@ int main(int argc, char **argv)
             s.addSelectables(o->getSelectables());
         }
 
+        s.addSelectable(&RetryTimer::getInstance());
+
         while (true)
         {
             Selectable *sel;
@@ -17,17 +17,22 @@
 
 #include <vector>
 #include <iostream>
+#include <algorithm>
 #include "configsync.h"
+#include "rediscommand.h"
+#include "redisreply.h"
+#include "dbconnectorpool.h"
+#include "latencytracer.h"
 
 ConfigSync::ConfigSync(string service_name,
                        string cfg_table_name,
                        string app_table_name):
     m_service_name(service_name),
-    m_cfg_db("CONFIG_DB", 0), 
-    m_appl_db("APPL_DB", 0),
-    m_cfg_table(&m_cfg_db, cfg_table_name.c_str()),
-    m_pst(&m_appl_db, app_table_name.c_str()),
-    m_sst(&m_cfg_db, cfg_table_name.c_str())
+    m_cfg_db(DBConnectorPool::getConnector("CONFIG_DB")),
+    m_appl_db(DBConnectorPool::getConnector("APPL_DB")),
+    m_cfg_table(m_cfg_db.get(), cfg_table_name.c_str()),
+    m_pst(DBConnectorPool::getPipeline("APPL_DB", "config-sync"), app_table_name.c_str(), true),
+    m_sst(m_cfg_db.get(), cfg_table_name.c_str())
 {
     SWSS_LOG_ENTER();
 }
@@ -99,13 +104,17 @@ bool ConfigSync::handleConfigFromConfigDB()
         return false;
     }
 
-    for (auto &k: keys)
+    vector<vector<FieldValueTuple>> values;
+
+    bulkGet(keys, values);
+
+    for (size_t i = 0; i < keys.size(); i++)
     {
-        bool valid = false;
+        const string &k = keys[i];
 
-        vector<FieldValueTuple> fvs;
+        bool valid = false;
 
-        m_cfg_table.get(k, fvs);
+        vector<FieldValueTuple> &fvs = values[i];
 
         for (auto &fv : fvs)
         {
@@ -127,6 +136,7 @@ bool ConfigSync::handleConfigFromConfigDB()
     FieldValueTuple count("count", to_string(m_entries.size()));
     vector<FieldValueTuple> configDoneFvs = { count };
     m_pst.set("ConfigDone", configDoneFvs);
+    m_pst.flush();
 
     return true;
 }
@@ -148,10 +158,77 @@ void ConfigSync::handleConfig(map<string, KeyOpFieldsValuesTuple> &cfg_map)
                         m_service_name.c_str(), key.c_str(), op.c_str());
         if (op == SET_COMMAND)
         {
+            /*
+             * Stamp the receive time of a traced write, the config is
+             * handled right after it is popped. See LatencyTracer.
+             */
+            auto id = find_if(values.begin(), values.end(),
+                [](const FieldValueTuple &fv) { return fvField(fv) == "operation-id"; });
+            if (id != values.end())
+            {
+                values.emplace_back("operation-ts", to_string(LatencyTracer::now()));
+            }
+
             m_pst.set(key, values);
         }
 
         it = cfg_map.erase(it);
     }
+
+    m_pst.flush();
+}
+
+/*
+ * Read the given keys of the config table with pipelined HGETALL commands,
+ * one round trip per CONFIG_BULK_READ_SIZE keys instead of one per key.
+ * A key removed in the meantime reads as an empty field list.
+ */
+void ConfigSync::bulkGet(const vector<string> &keys, vector<vector<FieldValueTuple>> &values)
+{
+    SWSS_LOG_ENTER();
+
+    redisContext *ctx = m_cfg_db->getContext();
+
+    values.clear();
+    values.resize(keys.size());
+
+    for (size_t start = 0; start < keys.size(); start += CONFIG_BULK_READ_SIZE)
+    {
+        size_t end = min(keys.size(), start + CONFIG_BULK_READ_SIZE);
+
+        for (size_t i = start; i < end; i++)
+        {
+            RedisCommand hgetall;
+            hgetall.format("HGETALL %s", m_cfg_table.getKeyName(keys[i]).c_str());
+
+            if (redisAppendFormattedCommand(ctx, hgetall.c_str(), hgetall.length()) != REDIS_OK)
+            {
+                SWSS_LOG_THROW("Failed to send HGETALL %s|%s",
+                               m_service_name.c_str(), keys[i].c_str());
+            }
+        }
+
+        for (size_t i = start; i < end; i++)
+        {
+            void *reply = NULL;
+
+            if (redisGetReply(ctx, &reply) != REDIS_OK)
+            {
+                SWSS_LOG_THROW("Failed to read HGETALL %s|%s",
+                               m_service_name.c_str(), keys[i].c_str());
+            }
+
+            RedisReply r(static_cast<redisReply *>(reply));
+            r.checkReplyType(REDIS_REPLY_ARRAY);
+
+            redisReply *fvs = r.getContext();
+            for (size_t j = 0; j + 1 < fvs->elements; j += 2)
+            {
+                values[i].emplace_back(fvs->element[j]->str, fvs->element[j + 1]->str);
+            }
+        }
+    }
+
+    SWSS_LOG_INFO("Read %zu %s entries from ConfigDB", keys.size(), m_service_name.c_str());
 }
 
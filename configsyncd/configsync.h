@@ -2,6 +2,7 @@
 #include <string>
 #include <set>
 #include <vector>
+#include <memory>
 #include "dbconnector.h"
 #include "producerstatetable.h"
 #include "subscriberstatetable.h"
@@ -9,6 +10,9 @@
 
 #define DEFAULT_SELECT_TIMEOUT 1000 /* ms */
 
+/* Number of HGETALL commands sent in one round trip by bulkGet() */
+#define CONFIG_BULK_READ_SIZE 512
+
 using namespace std;
 using namespace swss;
 
@@ -28,12 +32,14 @@ public:
 
 protected:
 
-    DBConnector m_cfg_db;
+    /* Connections are shared by all the ConfigSync instances */
+    shared_ptr<DBConnector> m_cfg_db;
 
-    DBConnector m_appl_db;
+    shared_ptr<DBConnector> m_appl_db;
 
     Table m_cfg_table;
 
+    /* Buffered on the shared "config-sync" pipeline, flushed at the end of each batch */
     ProducerStateTable m_pst;
 
     SubscriberStateTable m_sst;
@@ -45,5 +51,7 @@ protected:
     map<string, KeyOpFieldsValuesTuple> m_cfg_map;
 
     virtual void handleConfig(map<string, KeyOpFieldsValuesTuple> &cfg_map);
+
+    void bulkGet(const vector<string> &keys, vector<vector<FieldValueTuple>> &values);
 };
 
@@ -21,6 +21,7 @@
 #include "configsync.h"
 #include "ocm_configsync.h"
 #include "otdr_configsync.h"
+#include "dbconnectorpool.h"
 #include <thread>
 #include <chrono>
 
@@ -131,9 +132,9 @@ int main(int argc, char **argv)
             goto exit;
         }
 
-        DBConnector appl_db("APPL_DB", 0);
-        Table linecard_table(&appl_db, APP_OT_LINECARD_TABLE_NAME);
-        ProducerStateTable linecard_pst(&appl_db, APP_OT_LINECARD_TABLE_NAME);
+        auto appl_db = DBConnectorPool::getConnector("APPL_DB");
+        Table linecard_table(appl_db.get(), APP_OT_LINECARD_TABLE_NAME);
+        ProducerStateTable linecard_pst(appl_db.get(), APP_OT_LINECARD_TABLE_NAME);
         vector<FieldValueTuple> attrs;
         attrs.push_back(FieldValueTuple("object-count", to_string(objects.size())));
 
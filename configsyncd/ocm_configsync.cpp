@@ -20,6 +20,7 @@
 #include <string>
 #include <thread>
 #include <chrono>
+#include <inttypes.h>
 
 #include "ocm_configsync.h"
 #include "swss/tokenize.h"
@@ -33,6 +34,9 @@ using namespace swss;
 OcmGroupMgr::OcmGroupMgr(string groupName):
         m_groupName(groupName),
         m_runScanningThread(false),
+        m_scanInterval(DEFAULT_OCM_SCAN_INTERVAL),
+        m_scanTimeout(DEFAULT_OCM_SCAN_TIMEOUT),
+        m_requestId(0),
         m_cfgDb("CONFIG_DB", 0),
         m_applDb("APPL_DB", 0),
         m_stateDb("STATE_DB", 0),
@@ -40,7 +44,8 @@ OcmGroupMgr::OcmGroupMgr(string groupName):
         m_stateTable(&m_stateDb, STATE_OT_OCM_TABLE_NAME),
         m_appTable(&m_applDb, APP_OT_OCM_TABLE_NAME),
         m_queryChannel(&m_applDb, OT_OCM_NOTIFICATION),
-        m_replyChannel(&m_applDb, OT_OCM_REPLY)
+        m_replyChannel(&m_applDb, OT_OCM_REPLY),
+        m_resultPublisher(&m_stateDb)
 {
     SWSS_LOG_ENTER();
 
@@ -61,6 +66,10 @@ OcmGroupMgr::OcmGroupMgr(string groupName):
             m_freqGranularity = fv;
             updateFreqGranularity = true;
         }
+        else
+        {
+            parseScanParameter(fv);
+        }
     }
 
     if (m_ocmList.empty())
@@ -112,7 +121,7 @@ void OcmGroupMgr::stopScanningThread()
     {
         m_runScanningThread = false;
 
-        m_cvSleep.notify_all();
+        m_stopEvent.notify();
 
         if (m_scanningThread != nullptr)
         {
@@ -125,114 +134,206 @@ void OcmGroupMgr::stopScanningThread()
     }
 }
 
-OcmScanStatus OcmGroupMgr::scan(std::string ocm)
+ScanParameterStatus OcmGroupMgr::parseScanParameter(const FieldValueTuple &fv)
 {
     SWSS_LOG_ENTER();
 
-    string op = "set";
+    uint32_t *param;
 
-    FieldValueTuple fv = std::make_pair("scan", "true");
-
-    vector<FieldValueTuple> fvs = { fv };
+    if (fv.first == "scan-interval")
+    {
+        param = &m_scanInterval;
+    }
+    else if (fv.first == "scan-timeout")
+    {
+        param = &m_scanTimeout;
+    }
+    else
+    {
+        return SCAN_PARAMETER_NONE;
+    }
 
-    swss::Select s;
-    s.addSelectable(&m_replyChannel);
-    swss::Selectable *sel;
+    char *endptr = NULL;
+    unsigned long value = strtoul(fv.second.c_str(), &endptr, 10);
 
-    int waitTime = 20000;
-    
-    while (true)
+    if (endptr == fv.second.c_str() || *endptr != '\0' ||
+        (param == &m_scanTimeout && value == 0))
     {
-        m_queryChannel.send(op, ocm, fvs);
+        SWSS_LOG_ERROR("%s, invalid %s %s",
+                       m_groupName.c_str(), fv.first.c_str(), fv.second.c_str());
+        return SCAN_PARAMETER_INVALID;
+    }
 
-        int result = s.select(&sel, waitTime);
+    *param = (uint32_t)value;
+
+    return SCAN_PARAMETER_SET;
+}
+
+/*
+ * Send a scan query to every OCM which is due and has no scan in flight,
+ * and time out the scans past their deadline. The scans of different OCMs
+ * are independent and run concurrently. Returns the time in ms until the
+ * next deadline or due scan.
+ */
+int OcmGroupMgr::startScans()
+{
+    SWSS_LOG_ENTER();
+
+    MUTEX;
 
-        if (result == swss::Select::TIMEOUT)
+    auto now = std::chrono::steady_clock::now();
+    auto next = now + std::chrono::milliseconds(m_scanTimeout);
+
+    for (auto &it : m_scanStates)
+    {
+        const string &ocm = it.first;
+        OcmScanState &state = it.second;
+
+        if (!state.requestId.empty() && now >= state.deadline)
         {
             SWSS_LOG_ERROR("ocm scanning timeout, key=%s", ocm.c_str());
 
-            return OCM_SCAN_TIMEOUT;
+            finishScan(ocm, state, OCM_SCAN_TIMEOUT);
         }
-        else if (result == swss::Select::OBJECT)
+
+        if (state.requestId.empty() && now >= state.nextScan)
         {
-            std::deque<KeyOpFieldsValuesTuple> entries;
-            m_replyChannel.pops(entries);
+            SWSS_LOG_INFO("Begin to scan, ocm_group: %s, ocm: %s",
+                           m_groupName.c_str(), ocm.c_str());
 
-            bool found = false;
-            string op_ret;
+            state.requestId = to_string(++m_requestId);
+            state.started = now;
+            state.deadline = now + std::chrono::milliseconds(m_scanTimeout);
 
-            for (auto entry : entries)
-            {
-                string key = kfvKey(entry);
-                if (key == ocm)
-                {
-                    found = true;
-                    op_ret = kfvOp(entry);
-                }
-            }
-
-            if (!found)
-            {
-                continue;
-            }
+            vector<FieldValueTuple> fvs = {
+                {"scan", "true"},
+                {"request-id", state.requestId}
+            };
 
-            if (op_ret == "SUCCESS")
-            {
-                return OCM_SCAN_SUCCESS;
-            }
-            else if (op_ret == "UNAVAILABLE")
-            {
-                return OCM_SCAN_UNAVAILABLE;
-            }
-            else
-            {
-                return OCM_SCAN_FAILURE;
-            }
+            m_queryChannel.send("set", ocm, fvs);
         }
+
+        next = min(next, state.requestId.empty() ? state.nextScan : state.deadline);
     }
 
-    return OCM_SCAN_FAILURE;
+    auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(next - now).count();
+
+    return wait > 0 ? (int)wait : 0;
 }
 
-void OcmGroupMgr::scanningThreadRunFunction()
+/*
+ * Match the replies to the scans in flight by key and request-id. A reply
+ * without request-id is matched by key only.
+ */
+void OcmGroupMgr::handleScanReplies()
 {
     SWSS_LOG_ENTER();
 
-    while (m_runScanningThread)
-    {
-        int waitTime = 100;
+    std::deque<KeyOpFieldsValuesTuple> entries;
+    m_replyChannel.pops(entries);
 
-        MUTEX;
+    MUTEX;
 
-        for (auto &ocm : m_ocmList)
+    for (auto &entry : entries)
+    {
+        auto it = m_scanStates.find(kfvKey(entry));
+        if (it == m_scanStates.end() || it->second.requestId.empty())
         {
-            SWSS_LOG_INFO("Begin to scan, ocm_group: %s, ocm: %s",
-                           m_groupName.c_str(), ocm.c_str());
+            continue;
+        }
 
-            auto status = scan(ocm);
+        OcmScanState &state = it->second;
+        bool matched = true;
 
-            if (status == OCM_SCAN_UNAVAILABLE)
+        for (auto &fv : kfvFieldsValues(entry))
+        {
+            if (fv.first == "request-id")
             {
-                waitTime = 5000; 
+                matched = (fv.second == state.requestId);
                 break;
             }
+        }
 
-            if (m_runScanningThread == false)
-            {
-                break;
-            }
+        if (!matched)
+        {
+            SWSS_LOG_INFO("Ignore stale reply, ocm: %s", it->first.c_str());
+            continue;
         }
 
-        MUTEX_UNLOCK;
+        const string &op_ret = kfvOp(entry);
+        OcmScanStatus status;
+
+        if (op_ret == "SUCCESS")
+        {
+            status = OCM_SCAN_SUCCESS;
+        }
+        else if (op_ret == "UNAVAILABLE")
+        {
+            status = OCM_SCAN_UNAVAILABLE;
+        }
+        else
+        {
+            status = OCM_SCAN_FAILURE;
+        }
+
+        finishScan(it->first, state, status);
+    }
+}
+
+void OcmGroupMgr::finishScan(const string &ocm, OcmScanState &state, OcmScanStatus status)
+{
+    SWSS_LOG_ENTER();
+
+    auto now = std::chrono::steady_clock::now();
+
+    SWSS_LOG_INFO("End of scan, ocm: %s, status: %d, %" PRId64 " ms",
+                  ocm.c_str(), status,
+                  (int64_t)std::chrono::duration_cast<std::chrono::milliseconds>(now - state.started).count());
+
+    state.requestId.clear();
+
+    if (status == OCM_SCAN_UNAVAILABLE)
+    {
+        state.nextScan = now + std::chrono::milliseconds(OCM_SCAN_UNAVAILABLE_DELAY);
+    }
+    else
+    {
+        state.nextScan = state.started + std::chrono::milliseconds(m_scanInterval);
+    }
+}
+
+void OcmGroupMgr::scanningThreadRunFunction()
+{
+    SWSS_LOG_ENTER();
+
+    swss::Select s;
+    s.addSelectable(&m_replyChannel);
+    s.addSelectable(&m_stopEvent);
+
+    {
+        MUTEX;
+
+        auto now = std::chrono::steady_clock::now();
 
-        if (m_runScanningThread == false)
+        m_scanStates.clear();
+        for (auto &ocm : m_ocmList)
         {
-            break;
+            m_scanStates[ocm].nextScan = now;
         }
+    }
 
-        std::unique_lock<std::mutex> lk(m_mtxSleep);
+    while (m_runScanningThread)
+    {
+        int waitTime = startScans();
 
-        m_cvSleep.wait_for(lk, std::chrono::milliseconds(waitTime));
+        swss::Selectable *sel;
+
+        int result = s.select(&sel, waitTime);
+
+        if (result == swss::Select::OBJECT && sel == &m_replyChannel)
+        {
+            handleScanReplies();
+        }
     }
 }
 
@@ -252,6 +353,8 @@ void OcmGroupMgr::handleConfig(KeyOpFieldsValuesTuple &entry)
 
         bool updateFreqGranularity = false;
         bool updateOcmList = false;
+        vector<FieldValueTuple> scanParameters;
+        vector<FieldValueTuple> invalidParameters;
         string ocmList = "";
         string operationId = "";
 
@@ -272,6 +375,20 @@ void OcmGroupMgr::handleConfig(KeyOpFieldsValuesTuple &entry)
             {
                 operationId = fv.second;
             }
+            else
+            {
+                switch (parseScanParameter(fv))
+                {
+                case SCAN_PARAMETER_SET:
+                    scanParameters.push_back(fv);
+                    break;
+                case SCAN_PARAMETER_INVALID:
+                    invalidParameters.push_back(fv);
+                    break;
+                default:
+                    break;
+                }
+            }
         }
 
         if (updateFreqGranularity)
@@ -301,9 +418,27 @@ void OcmGroupMgr::handleConfig(KeyOpFieldsValuesTuple &entry)
             string channel = "ocm-list";
             channel += "-" + operationId;
             string error_msg = "Set " + key + " ocm-list to " + ocmList;
-            swss::NotificationProducer notifications(&m_stateDb, channel);
             std::vector<swss::FieldValueTuple> entry;
-            notifications.send("0", error_msg, entry);
+            m_resultPublisher.publish(channel, "0", error_msg, entry);
+        }
+
+        if (operationId != "")
+        {
+            for (auto &fv : scanParameters)
+            {
+                string channel = fv.first + "-" + operationId;
+                string error_msg = "Set " + key + " " + fv.first + " to " + fv.second;
+                std::vector<swss::FieldValueTuple> entry;
+                m_resultPublisher.publish(channel, "0", error_msg, entry);
+            }
+
+            for (auto &fv : invalidParameters)
+            {
+                string channel = fv.first + "-" + operationId;
+                string error_msg = "Invalid " + fv.first + " " + fv.second + " of " + key;
+                std::vector<swss::FieldValueTuple> entry;
+                m_resultPublisher.publish(channel, OCM_CONFIG_FAILURE, error_msg, entry);
+            }
         }
 
         if (updateFreqGranularity && operationId != "" && m_ocmList.empty())
@@ -311,17 +446,18 @@ void OcmGroupMgr::handleConfig(KeyOpFieldsValuesTuple &entry)
             string channel = "frequency-granularity";
             channel += "-" + operationId;
             string error_msg = "Set " + key + " frequency-granularity to " + m_freqGranularity.second;
-            swss::NotificationProducer notifications(&m_stateDb, channel);
             std::vector<swss::FieldValueTuple> entry;
-            notifications.send("0", error_msg, entry);
+            m_resultPublisher.publish(channel, "0", error_msg, entry);
         }
+
+        m_resultPublisher.flush();
     }
 }
 
 OcmConfigSync::OcmConfigSync():
         ConfigSync("ocmsync", CFG_OT_OCM_TABLE_NAME, APP_OT_OCM_TABLE_NAME),
-        m_cfgOcmGroupTable(&m_cfg_db, CFG_OT_OCM_GROUP_TABLE_NAME),
-        m_cfgOcmGroupSubStateTable(&m_cfg_db, CFG_OT_OCM_GROUP_TABLE_NAME)
+        m_cfgOcmGroupTable(m_cfg_db.get(), CFG_OT_OCM_GROUP_TABLE_NAME),
+        m_cfgOcmGroupSubStateTable(m_cfg_db.get(), CFG_OT_OCM_GROUP_TABLE_NAME)
 {
     SWSS_LOG_ENTER();
 }
@@ -1,14 +1,29 @@
 #pragma once
 
 #include <memory>
-#include <condition_variable>
 #include <mutex>
+#include <map>
+#include <chrono>
 
 #include "dbconnector.h"
 #include "configsync.h"
 #include "producerstatetable.h"
 #include "notificationproducer.h"
 #include "notificationconsumer.h"
+#include "selectableevent.h"
+#include "resultpublisher.h"
+
+/* Minimum time between the starts of two scans of the same OCM */
+#define DEFAULT_OCM_SCAN_INTERVAL 100 /* ms */
+
+/* Time given to one scan to complete */
+#define DEFAULT_OCM_SCAN_TIMEOUT 20000 /* ms */
+
+/* Delay before scanning again an OCM while orchagent is not working */
+#define OCM_SCAN_UNAVAILABLE_DELAY 5000 /* ms */
+
+/* Status published for an invalid field, OTAI_STATUS_FAILURE */
+#define OCM_CONFIG_FAILURE "-1"
 
 namespace swss
 {
@@ -20,6 +35,26 @@ namespace swss
         OCM_SCAN_UNAVAILABLE,
     } OcmScanStatus;
 
+    typedef enum ScanParameterStatus_E
+    {
+        SCAN_PARAMETER_NONE,
+        SCAN_PARAMETER_SET,
+        SCAN_PARAMETER_INVALID,
+    } ScanParameterStatus;
+
+    /*
+     * Scan state of one OCM. requestId is set while a scan is in flight and
+     * is carried by the query and its reply, so that a late reply to a
+     * timed out scan is not taken for the reply to the next one.
+     */
+    struct OcmScanState
+    {
+        std::string requestId;
+        std::chrono::steady_clock::time_point started;
+        std::chrono::steady_clock::time_point deadline;
+        std::chrono::steady_clock::time_point nextScan;
+    };
+
     class OcmGroupMgr
     {
 
@@ -43,10 +78,6 @@ namespace swss
 
         std::mutex m_mtx;
 
-        std::mutex m_mtxSleep;
-
-        std::condition_variable m_cvSleep;
-
         DBConnector m_cfgDb;
 
         DBConnector m_applDb;
@@ -71,9 +102,28 @@ namespace swss
 
         swss::NotificationConsumer m_replyChannel;
 
+        ResultPublisher m_resultPublisher;
+
         std::shared_ptr<std::thread> m_scanningThread;
 
-        OcmScanStatus scan(std::string ocm);
+        /* Wakes up the scanning thread when it has to stop */
+        swss::SelectableEvent m_stopEvent;
+
+        uint32_t m_scanInterval;
+
+        uint32_t m_scanTimeout;
+
+        uint64_t m_requestId;
+
+        std::map<std::string, OcmScanState> m_scanStates;
+
+        ScanParameterStatus parseScanParameter(const FieldValueTuple &fv);
+
+        int startScans();
+
+        void handleScanReplies();
+
+        void finishScan(const std::string &ocm, OcmScanState &state, OcmScanStatus status);
 
     };
 
@@ -20,6 +20,8 @@
 #include <string>
 #include <thread>
 #include <chrono>
+#include <algorithm>
+#include <inttypes.h>
  
 #include "otdr_configsync.h"
 #include "swss/tokenize.h"
@@ -27,258 +29,489 @@
 using namespace std;
 using namespace swss;
 
-std::mutex OtdrScanningMgr::m_mtx;
-
-#define MUTEX std::unique_lock<std::mutex> _lock(OtdrScanningMgr::m_mtx);
+#define MUTEX std::unique_lock<std::mutex> _lock(m_mtx);
 #define MUTEX_UNLOCK _lock.unlock();
  
-OtdrScanningMgr::OtdrScanningMgr(string otdrName, 
+OtdrScanningMgr::OtdrScanningMgr(OtdrScanScheduler &scheduler,
+                                 string otdrName,
                                  bool enable,
                                  uint64_t startTime,
                                  uint32_t period):
+        m_scheduler(scheduler),
         m_otdrName(otdrName),
-        m_applDb("APPL_DB", 0),
-        m_stateDb("STATE_DB", 0),
-        m_stateTable(&m_stateDb, STATE_OT_OTDR_TABLE_NAME),
-        m_queryChannel(&m_applDb, OT_OTDR_NOTIFICATION),
-        m_replyChannel(&m_applDb, OT_OTDR_REPLY),
-        m_startTime(startTime)
+        m_enable(false),
+        m_startTime(0),
+        m_period(DEFAULT_OTDR_SCAN_PERIOD),
+        m_queued(false),
+        m_scanCount(0),
+        m_timeoutCount(0),
+        m_missedCount(0),
+        m_latencyMsTotal(0),
+        m_latencyMsMax(0),
+        m_queueDelayMsTotal(0),
+        m_queueDelayMsMax(0)
 {
     SWSS_LOG_ENTER();
 
-    if (period)
-    {
-        m_period = period;
-    }
-    else
-    {
-        m_period = 30 * 60 * 1000; /* 30 minutes */
-    }
-
-    if (enable)
-    {
-        startScanningThread();
-    }
+    m_scheduler.schedule(this, enable, startTime, period);
 }
  
 OtdrScanningMgr::~OtdrScanningMgr()
 {
     SWSS_LOG_ENTER();
  
-    stopScanningThread();
+    m_scheduler.cancel(this);
 }
  
-void OtdrScanningMgr::startScanningThread()
+void OtdrScanningMgr::updatePeriodicScanningParameter(
+        bool enable,
+        uint64_t startTime,
+        uint32_t period)
 {
     SWSS_LOG_ENTER();
- 
-    m_runScanningThread = true;
- 
-    m_scanningThread = make_shared<thread>(&OtdrScanningMgr::scanningThreadRunFunction, this);
- 
-    SWSS_LOG_NOTICE("%s, OTDR scanning Thread started.", m_otdrName.c_str());
+
+    m_scheduler.schedule(this, enable, startTime, period);
 }
- 
-void OtdrScanningMgr::stopScanningThread()
+
+OtdrScanScheduler::OtdrScanScheduler():
+        m_applDb("APPL_DB", 0),
+        m_stateDb("STATE_DB", 0),
+        m_stateTable(&m_stateDb, STATE_OT_OTDR_TABLE_NAME),
+        m_queryChannel(&m_applDb, OT_OTDR_NOTIFICATION),
+        m_replyChannel(&m_applDb, OT_OTDR_REPLY),
+        m_runThread(true),
+        m_wheel(OTDR_WHEEL_SLOTS),
+        m_cursor(0),
+        m_cursorTime(chrono::steady_clock::now()),
+        m_activeScan(NULL)
 {
     SWSS_LOG_ENTER();
- 
-    if (m_runScanningThread)
+
+    m_thread = make_shared<thread>(&OtdrScanScheduler::threadRunFunction, this);
+
+    SWSS_LOG_NOTICE("OTDR scanning Thread started.");
+}
+
+OtdrScanScheduler::~OtdrScanScheduler()
+{
+    SWSS_LOG_ENTER();
+
     {
-        m_runScanningThread = false;
- 
-        m_cvSleep.notify_all();
- 
-        if (m_scanningThread != nullptr)
-        {
-            auto fcThread = std::move(m_scanningThread);
- 
-            fcThread->join();
-        }
- 
-        SWSS_LOG_NOTICE("%s, OTDR scanning Thread ended.", m_otdrName.c_str());
+        MUTEX;
+        m_runThread = false;
+    }
+
+    m_wakeupEvent.notify();
+
+    if (m_thread != nullptr)
+    {
+        auto fcThread = std::move(m_thread);
+
+        fcThread->join();
     }
+
+    SWSS_LOG_NOTICE("OTDR scanning Thread ended.");
 }
 
-bool OtdrScanningMgr::queryScanningStatus(OtdrScanningStatus &status)
+void OtdrScanScheduler::schedule(OtdrScanningMgr *mgr,
+                                 bool enable,
+                                 uint64_t startTime,
+                                 uint32_t period)
 {
     SWSS_LOG_ENTER();
 
-    bool ret = false;
+    if (period == 0)
+    {
+        period = DEFAULT_OTDR_SCAN_PERIOD;
+    }
 
-    string value;
+    MUTEX;
 
-    if (m_stateTable.hget(m_otdrName, "scanning-status", value))
+    bool scheduled = mgr->m_enable;
+
+    if (scheduled == enable &&
+        startTime == mgr->m_startTime &&
+        period == mgr->m_period)
     {
-        if (value == "INACTIVE")
+        return;
+    }
+
+    cancelLocked(mgr);
+
+    mgr->m_enable = enable;
+    mgr->m_startTime = startTime;
+    mgr->m_period = period;
+
+    if (!enable)
+    {
+        SWSS_LOG_NOTICE("%s, OTDR periodic scanning disabled.", mgr->m_otdrName.c_str());
+        return;
+    }
+
+    /*
+     * Without start-time the first scan runs right away, otherwise the
+     * scans are aligned on start-time + n * period.
+     */
+    auto now = chrono::steady_clock::now();
+    long delay = 0;
+
+    if (startTime)
+    {
+        const auto p = chrono::system_clock::now().time_since_epoch();
+
+        long currentTimeMs = (long)chrono::duration_cast<chrono::milliseconds>(p).count();
+
+        long startTimeMs = (long)(startTime / 1000000);
+
+        if (startTimeMs >= currentTimeMs)
         {
-            ret = true;
-            status = OTDR_SCANNING_STATUS_INACTIVE;
+            delay = startTimeMs - currentTimeMs;
         }
-        else if (value == "ACTIVE")
+        else
         {
-            ret = true;
-            status = OTDR_SCANNING_STATUS_ACTIVE;
+            delay = period - ((currentTimeMs - startTimeMs) % period);
         }
     }
 
-    return ret;
+    SWSS_LOG_NOTICE("%s, OTDR periodic scanning enabled, period %u, delay %ld",
+                    mgr->m_otdrName.c_str(), period, delay);
+
+    mgr->m_nextDue = now + chrono::milliseconds(delay);
+
+    addToWheel(mgr);
+
+    MUTEX_UNLOCK;
+
+    m_wakeupEvent.notify();
 }
 
-void OtdrScanningMgr::scan()
+void OtdrScanScheduler::cancel(OtdrScanningMgr *mgr)
 {
     SWSS_LOG_ENTER();
 
-    OtdrScanningStatus scanningStatus = OTDR_SCANNING_STATUS_ACTIVE;
+    MUTEX;
+
+    cancelLocked(mgr);
+
+    mgr->m_enable = false;
+}
+
+void OtdrScanScheduler::cancelLocked(OtdrScanningMgr *mgr)
+{
+    SWSS_LOG_ENTER();
 
-    if (!queryScanningStatus(scanningStatus))
+    for (auto &slot : m_wheel)
     {
-        SWSS_LOG_INFO("skip scan %s, get scanning status failed", m_otdrName.c_str());
-        return;
+        slot.erase(remove_if(slot.begin(), slot.end(),
+                             [mgr](const WheelEntry &entry) { return entry.mgr == mgr; }),
+                   slot.end());
     }
 
-    if (scanningStatus == OTDR_SCANNING_STATUS_ACTIVE)
+    m_readyQueue.erase(remove(m_readyQueue.begin(), m_readyQueue.end(), mgr),
+                       m_readyQueue.end());
+    mgr->m_queued = false;
+
+    /* The reply of the running scan, if any, is ignored */
+    if (m_activeScan == mgr)
     {
-        SWSS_LOG_INFO("skip scan %s, it is inactive", m_otdrName.c_str());
-        return;
+        m_activeScan = NULL;
     }
- 
-    string op = "set";
- 
-    FieldValueTuple fv = std::make_pair("scan", "true");
- 
-    vector<FieldValueTuple> fvs = { fv };
- 
-    swss::Select s;
-    s.addSelectable(&m_replyChannel);
-    swss::Selectable *sel;
+}
 
-    int waitTime = 20000; // 20 seconds
+/*
+ * Insert the next scan of mgr at m_nextDue. The slot is rounded up to the
+ * next tick and rounds counts the full turns of the wheel still to wait.
+ */
+void OtdrScanScheduler::addToWheel(OtdrScanningMgr *mgr)
+{
+    auto delay = chrono::duration_cast<chrono::milliseconds>(mgr->m_nextDue - m_cursorTime).count();
 
-    m_queryChannel.send(op, m_otdrName, fvs);
+    uint64_t ticks = delay > 0 ? ((uint64_t)delay + OTDR_WHEEL_TICK_MS - 1) / OTDR_WHEEL_TICK_MS : 1;
 
-    int result = s.select(&sel, waitTime);
- 
-    if (result == swss::Select::TIMEOUT)
+    size_t slot = (size_t)((m_cursor + ticks) % OTDR_WHEEL_SLOTS);
+
+    m_wheel[slot].push_back({mgr, (uint32_t)((ticks - 1) / OTDR_WHEEL_SLOTS)});
+}
+
+/*
+ * Queue the scan of mgr which is due, and put its next scan in the wheel.
+ * Periods elapsed while the scan was queued or running are missed.
+ */
+void OtdrScanScheduler::setDue(OtdrScanningMgr *mgr, chrono::steady_clock::time_point now)
+{
+    if (mgr->m_queued || m_activeScan == mgr)
     {
-        SWSS_LOG_ERROR("otdr scanning timeout, key=%s", m_otdrName.c_str());
-        return;
+        SWSS_LOG_WARN("%s, OTDR is still busy, scan is missed", mgr->m_otdrName.c_str());
+        mgr->m_missedCount++;
     }
-    else if (result == swss::Select::OBJECT)
+    else
     {
-        std::deque<KeyOpFieldsValuesTuple> entries;
-        m_replyChannel.pops(entries);
+        mgr->m_queued = true;
+        mgr->m_queuedDue = mgr->m_nextDue;
+        m_readyQueue.push_back(mgr);
+    }
 
-        bool found = false;
-        string op_ret;
- 
-        for (auto entry : entries)
+    auto period = chrono::milliseconds(mgr->m_period);
+
+    do
+    {
+        mgr->m_nextDue += period;
+    }
+    while (mgr->m_nextDue <= now);
+
+    addToWheel(mgr);
+}
+
+void OtdrScanScheduler::advanceWheel(chrono::steady_clock::time_point now)
+{
+    auto tick = chrono::milliseconds(OTDR_WHEEL_TICK_MS);
+
+    while (m_cursorTime + tick <= now)
+    {
+        m_cursor = (m_cursor + 1) % OTDR_WHEEL_SLOTS;
+        m_cursorTime += tick;
+
+        vector<WheelEntry> due;
+        auto &slot = m_wheel[m_cursor];
+
+        for (auto it = slot.begin(); it != slot.end();)
         {
-            string key = kfvKey(entry);
-            if (key == m_otdrName)
+            if (it->rounds == 0)
+            {
+                due.push_back(*it);
+                it = slot.erase(it);
+            }
+            else
             {
-                found = true;
-                op_ret = kfvOp(entry);
+                it->rounds--;
+                ++it;
             }
         }
- 
-        if (found && op_ret != "SUCCESS")
+
+        for (auto &entry : due)
         {
-            SWSS_LOG_INFO("otdr failed to scan, key=%s, ret=%s",
-                          m_otdrName.c_str(), op_ret.c_str());
+            setDue(entry.mgr, now);
         }
     }
 }
- 
-void OtdrScanningMgr::scanningThreadRunFunction()
+
+/*
+ * Time in ms until the first slot holding a due scan, or one full turn of
+ * the wheel when only later rounds are pending, bounded by the deadline of
+ * the running scan. -1 when there is nothing to wait for.
+ */
+int OtdrScanScheduler::getWaitTime(chrono::steady_clock::time_point now)
 {
-    SWSS_LOG_ENTER();
+    chrono::steady_clock::time_point wakeup = chrono::steady_clock::time_point::max();
+    bool pending = false;
 
-    if (m_startTime)
+    for (size_t k = 1; k <= OTDR_WHEEL_SLOTS; k++)
     {
-        const auto p = chrono::system_clock::now().time_since_epoch();
+        auto &slot = m_wheel[(m_cursor + k) % OTDR_WHEEL_SLOTS];
 
-        auto currentTimeMs = chrono::duration_cast<chrono::milliseconds>(p).count();
-
-        long startTimeMs = m_startTime / 1000000;
-
-        long delay;
-
-        if (startTimeMs >= currentTimeMs)
+        bool due = false;
+        for (auto &entry : slot)
         {
-            delay = startTimeMs - currentTimeMs;
+            pending = true;
+            if (entry.rounds == 0)
+            {
+                due = true;
+                break;
+            }
         }
-        else if (startTimeMs < currentTimeMs)
+
+        if (due)
         {
-            delay = m_period - ((currentTimeMs - startTimeMs) % m_period);
+            wakeup = m_cursorTime + chrono::milliseconds(k * OTDR_WHEEL_TICK_MS);
+            break;
         }
-
-        SWSS_LOG_INFO("%s, delay %ld", m_otdrName.c_str(), delay);
-        std::unique_lock<std::mutex> lk(m_mtxSleep);
-        m_cvSleep.wait_for(lk, std::chrono::milliseconds(delay));
     }
- 
-    while (m_runScanningThread)
+
+    if (pending && wakeup == chrono::steady_clock::time_point::max())
     {
-        auto start = std::chrono::steady_clock::now();
+        wakeup = m_cursorTime + chrono::milliseconds(OTDR_WHEEL_SLOTS * OTDR_WHEEL_TICK_MS);
+    }
 
-        SWSS_LOG_INFO("Begin to scan, otdr: %s", m_otdrName.c_str());
+    if (m_activeScan != NULL)
+    {
+        wakeup = min(wakeup, m_activeDeadline);
+    }
 
-        MUTEX;
+    if (wakeup == chrono::steady_clock::time_point::max())
+    {
+        return -1;
+    }
 
-        scan();
+    auto wait = chrono::duration_cast<chrono::milliseconds>(wakeup - now).count();
 
-        MUTEX_UNLOCK;
+    return wait > 0 ? (int)wait : 0;
+}
 
-        auto finish = std::chrono::steady_clock::now();
+bool OtdrScanScheduler::queryScanningStatus(const string &otdr, OtdrScanningStatus &status)
+{
+    SWSS_LOG_ENTER();
 
-        uint32_t delay = static_cast<uint32_t>(chrono::duration_cast<chrono::milliseconds>(finish - start).count());
+    bool ret = false;
 
-        uint32_t correction = delay % m_period;
+    string value;
 
-        correction = m_period - correction;
- 
-        if (m_runScanningThread == false)
+    if (m_stateTable.hget(otdr, "scanning-status", value))
+    {
+        if (value == "INACTIVE")
         {
-            break;
+            ret = true;
+            status = OTDR_SCANNING_STATUS_INACTIVE;
+        }
+        else if (value == "ACTIVE")
+        {
+            ret = true;
+            status = OTDR_SCANNING_STATUS_ACTIVE;
         }
-
-        std::unique_lock<std::mutex> lk(m_mtxSleep);
- 
-        m_cvSleep.wait_for(lk, std::chrono::milliseconds(correction));
     }
+
+    return ret;
 }
- 
-void OtdrScanningMgr::updatePeriodicScanningParameter(
-        bool enable,
-        uint64_t startTime,
-        uint32_t period)
+
+void OtdrScanScheduler::startNextScan(chrono::steady_clock::time_point now)
 {
     SWSS_LOG_ENTER();
 
-    if (enable == m_runScanningThread &&
-        startTime == m_startTime && 
-        period == m_period)
+    while (m_activeScan == NULL && !m_readyQueue.empty())
     {
-        return;
+        OtdrScanningMgr *mgr = m_readyQueue.front();
+        m_readyQueue.pop_front();
+        mgr->m_queued = false;
+
+        const string &otdr = mgr->m_otdrName;
+        OtdrScanningStatus scanningStatus = OTDR_SCANNING_STATUS_ACTIVE;
+
+        if (!queryScanningStatus(otdr, scanningStatus))
+        {
+            SWSS_LOG_INFO("skip scan %s, get scanning status failed", otdr.c_str());
+            continue;
+        }
+
+        if (scanningStatus == OTDR_SCANNING_STATUS_ACTIVE)
+        {
+            SWSS_LOG_INFO("skip scan %s, it is inactive", otdr.c_str());
+            continue;
+        }
+
+        SWSS_LOG_INFO("Begin to scan, otdr: %s", otdr.c_str());
+
+        uint64_t queueDelay = (uint64_t)chrono::duration_cast<chrono::milliseconds>(now - mgr->m_queuedDue).count();
+        mgr->m_queueDelayMsTotal += queueDelay;
+        mgr->m_queueDelayMsMax = max(mgr->m_queueDelayMsMax, queueDelay);
+
+        vector<FieldValueTuple> fvs = { {"scan", "true"} };
+
+        m_queryChannel.send("set", otdr, fvs);
+
+        m_activeScan = mgr;
+        m_activeSent = now;
+        m_activeDeadline = now + chrono::milliseconds(OTDR_SCAN_WAIT_TIME);
     }
+}
+
+void OtdrScanScheduler::finishScan(OtdrScanStatus status, chrono::steady_clock::time_point now)
+{
+    SWSS_LOG_ENTER();
 
-    stopScanningThread();
+    OtdrScanningMgr *mgr = m_activeScan;
+    m_activeScan = NULL;
 
-    m_startTime = startTime;
+    uint64_t latency = (uint64_t)chrono::duration_cast<chrono::milliseconds>(now - m_activeSent).count();
 
-    if (period)
+    mgr->m_scanCount++;
+    if (status == OTDR_SCAN_TIMEOUT)
     {
-        m_period = period;
+        mgr->m_timeoutCount++;
     }
-    else
+    mgr->m_latencyMsTotal += latency;
+    mgr->m_latencyMsMax = max(mgr->m_latencyMsMax, latency);
+
+    SWSS_LOG_INFO("End of scan, otdr: %s, status: %d, latency %" PRIu64 " ms "
+                  "(avg %" PRIu64 ", max %" PRIu64 "), queue delay avg %" PRIu64 " ms, "
+                  "max %" PRIu64 " ms, scans %" PRIu64 ", timeouts %" PRIu64 ", missed %" PRIu64,
+                  mgr->m_otdrName.c_str(), status, latency,
+                  mgr->m_latencyMsTotal / mgr->m_scanCount, mgr->m_latencyMsMax,
+                  mgr->m_queueDelayMsTotal / mgr->m_scanCount, mgr->m_queueDelayMsMax,
+                  mgr->m_scanCount, mgr->m_timeoutCount, mgr->m_missedCount);
+}
+
+void OtdrScanScheduler::handleReplies()
+{
+    SWSS_LOG_ENTER();
+
+    std::deque<KeyOpFieldsValuesTuple> entries;
+    m_replyChannel.pops(entries);
+
+    MUTEX;
+
+    for (auto &entry : entries)
     {
-        m_period = 30 * 60 * 1000; /* 30 minutes */
+        if (m_activeScan == NULL || kfvKey(entry) != m_activeScan->m_otdrName)
+        {
+            continue;
+        }
+
+        const string &op_ret = kfvOp(entry);
+
+        if (op_ret != "SUCCESS")
+        {
+            SWSS_LOG_INFO("otdr failed to scan, key=%s, ret=%s",
+                          m_activeScan->m_otdrName.c_str(), op_ret.c_str());
+        }
+
+        finishScan(op_ret == "SUCCESS" ? OTDR_SCAN_SUCCESS : OTDR_SCAN_FAILURE,
+                   chrono::steady_clock::now());
     }
+}
+
+void OtdrScanScheduler::threadRunFunction()
+{
+    SWSS_LOG_ENTER();
 
-    if (enable)
+    swss::Select s;
+    s.addSelectable(&m_replyChannel);
+    s.addSelectable(&m_wakeupEvent);
+
+    while (true)
     {
-        startScanningThread();
+        int waitTime;
+
+        {
+            MUTEX;
+
+            if (!m_runThread)
+            {
+                break;
+            }
+
+            auto now = chrono::steady_clock::now();
+
+            advanceWheel(now);
+
+            if (m_activeScan != NULL && now >= m_activeDeadline)
+            {
+                SWSS_LOG_ERROR("otdr scanning timeout, key=%s", m_activeScan->m_otdrName.c_str());
+
+                finishScan(OTDR_SCAN_TIMEOUT, now);
+            }
+
+            startNextScan(now);
+
+            waitTime = getWaitTime(now);
+        }
+
+        swss::Selectable *sel;
+
+        int result = s.select(&sel, waitTime);
+
+        if (result == swss::Select::OBJECT && sel == &m_replyChannel)
+        {
+            handleReplies();
+        }
     }
 }
  
@@ -302,11 +535,16 @@ bool OtdrConfigSync::handleConfigFromConfigDB()
         return false;
     }
  
-    for (auto &k: m_entries)
+    vector<string> keys(m_entries.begin(), m_entries.end());
+    vector<vector<FieldValueTuple>> values;
+
+    bulkGet(keys, values);
+
+    for (size_t i = 0; i < keys.size(); i++)
     {
-        vector<FieldValueTuple> fvs;
+        const string &k = keys[i];
 
-        m_cfg_table.get(k, fvs);
+        vector<FieldValueTuple> &fvs = values[i];
 
         bool enable = false;
 
@@ -335,7 +573,8 @@ bool OtdrConfigSync::handleConfigFromConfigDB()
             }
         }
 
-        m_otdrScanningMgrs[k] = make_shared<OtdrScanningMgr>(k,
+        m_otdrScanningMgrs[k] = make_shared<OtdrScanningMgr>(m_scheduler,
+                                                             k,
                                                              enable,
                                                              startTime,
                                                              period);
@@ -1,14 +1,25 @@
 #pragma once
 
 #include <memory>
-#include <condition_variable>
 #include <mutex>
+#include <deque>
+#include <chrono>
  
 #include "dbconnector.h"
 #include "configsync.h"
 #include "producerstatetable.h"
 #include "notificationproducer.h"
 #include "notificationconsumer.h"
+#include "selectableevent.h"
+
+#define OTDR_WHEEL_TICK_MS 100
+#define OTDR_WHEEL_SLOTS 600
+
+/* Scan period used when none is configured */
+#define DEFAULT_OTDR_SCAN_PERIOD (30 * 60 * 1000) /* ms */
+
+/* Time given to one scan to complete */
+#define OTDR_SCAN_WAIT_TIME 20000 /* ms */
 
 namespace swss
 {
@@ -28,59 +39,155 @@ namespace swss
         OTDR_SCANNING_STATUS_INACTIVE,
     } OtdrScanningStatus;
 
+    class OtdrScanScheduler;
+
+    /*
+     * Periodic scanning of one OTDR. The scans of all OTDRs are driven by
+     * the OtdrScanScheduler of the OtdrConfigSync, the manager only holds
+     * the parameters, the scheduling state and the statistics of the OTDR.
+     */
     class OtdrScanningMgr
     {
  
     public:
  
-        OtdrScanningMgr(std::string otdrName,
+        OtdrScanningMgr(OtdrScanScheduler &scheduler,
+                        std::string otdrName,
                         bool enable,
                         uint64_t startTime,
                         uint32_t period);
  
         ~OtdrScanningMgr();
  
-        void startScanningThread();
- 
-        void stopScanningThread();
- 
-        void scanningThreadRunFunction();
- 
         void updatePeriodicScanningParameter(bool enable,
                                              uint64_t startTime,
                                              uint32_t period);
 
     private:
 
-        static std::mutex m_mtx;
- 
-        std::mutex m_mtxSleep;
- 
-        std::condition_variable m_cvSleep;
- 
-        DBConnector m_applDb;
+        friend class OtdrScanScheduler;
 
-        DBConnector m_stateDb;
+        OtdrScanScheduler &m_scheduler;
 
-        Table m_stateTable;
- 
-        bool m_runScanningThread;
- 
         std::string m_otdrName;
 
+        bool m_enable;
+
         uint64_t m_startTime; /* units: nanosecond */
 
         uint32_t m_period; /* units: millisecond */
- 
+
+        /* Scheduling state, protected by the mutex of the scheduler */
+
+        std::chrono::steady_clock::time_point m_nextDue;
+
+        std::chrono::steady_clock::time_point m_queuedDue;
+
+        bool m_queued;
+
+        /* Scan statistics */
+
+        uint64_t m_scanCount;
+
+        uint64_t m_timeoutCount;
+
+        uint64_t m_missedCount;
+
+        uint64_t m_latencyMsTotal;
+
+        uint64_t m_latencyMsMax;
+
+        uint64_t m_queueDelayMsTotal;
+
+        uint64_t m_queueDelayMsMax;
+
+    };
+
+    /*
+     * OtdrScanScheduler runs the periodic scans of all OTDRs from a single
+     * thread. The next scan of each OTDR sits in a hashed timer wheel of
+     * OTDR_WHEEL_SLOTS slots of OTDR_WHEEL_TICK_MS, the thread only wakes
+     * up for the slots holding a due scan, a reply or a deadline.
+     *
+     * The OTDR hardware runs one scan at a time. Due scans wait in a FIFO
+     * queue so that OTDRs sharing a period take turns, and a scan which is
+     * still queued or running when it comes due again is counted as missed.
+     */
+    class OtdrScanScheduler
+    {
+
+    public:
+
+        OtdrScanScheduler();
+
+        ~OtdrScanScheduler();
+
+        void schedule(OtdrScanningMgr *mgr,
+                      bool enable,
+                      uint64_t startTime,
+                      uint32_t period);
+
+        void cancel(OtdrScanningMgr *mgr);
+
+    private:
+
+        struct WheelEntry
+        {
+            OtdrScanningMgr *mgr;
+            uint32_t rounds;
+        };
+
+        std::mutex m_mtx;
+
+        DBConnector m_applDb;
+
+        DBConnector m_stateDb;
+
+        Table m_stateTable;
+
         swss::NotificationProducer m_queryChannel;
- 
+
         swss::NotificationConsumer m_replyChannel;
- 
-        std::shared_ptr<std::thread> m_scanningThread;
- 
-        void scan();
 
-        bool queryScanningStatus(OtdrScanningStatus &status); 
+        swss::SelectableEvent m_wakeupEvent;
+
+        bool m_runThread;
+
+        std::shared_ptr<std::thread> m_thread;
+
+        std::vector<std::vector<WheelEntry>> m_wheel;
+
+        size_t m_cursor;
+
+        std::chrono::steady_clock::time_point m_cursorTime;
+
+        std::deque<OtdrScanningMgr *> m_readyQueue;
+
+        OtdrScanningMgr *m_activeScan;
+
+        std::chrono::steady_clock::time_point m_activeSent;
+
+        std::chrono::steady_clock::time_point m_activeDeadline;
+
+        void threadRunFunction();
+
+        void cancelLocked(OtdrScanningMgr *mgr);
+
+        void addToWheel(OtdrScanningMgr *mgr);
+
+        void advanceWheel(std::chrono::steady_clock::time_point now);
+
+        void setDue(OtdrScanningMgr *mgr, std::chrono::steady_clock::time_point now);
+
+        int getWaitTime(std::chrono::steady_clock::time_point now);
+
+        void startNextScan(std::chrono::steady_clock::time_point now);
+
+        void handleReplies();
+
+        void finishScan(OtdrScanStatus status, std::chrono::steady_clock::time_point now);
+
+        bool queryScanningStatus(const std::string &otdr, OtdrScanningStatus &status);
 
     };
  
@@ -100,6 +207,9 @@ namespace swss
         void doTask(Selectable *);
  
     private:
+
+        /* Declared first so that it outlives the managers */
+        OtdrScanScheduler m_scheduler;
  
         std::map<std::string, std::shared_ptr<OtdrScanningMgr>> m_otdrScanningMgrs;
  
@@ -23,7 +23,6 @@ using namespace std;
 using namespace swss;
 
 extern FlexCounterOrch *gFlexCounterOrch;
-extern std::unordered_set<std::string> aps_counter_ids_status;
 
 vector<otai_attr_id_t> g_aps_cfg_attrs =
 {
@@ -86,6 +85,6 @@ void ApsOrch::addExtraAttrsOnCreate(vector<otai_attribute_t> &attrs)
 
 void ApsOrch::setFlexCounter(otai_object_id_t id, vector<otai_attribute_t> &attrs)
 {
-    gFlexCounterOrch->getStatusGroup()->setCounterIdList(id, CounterType::APS_STATUS, aps_counter_ids_status);
+    gFlexCounterOrch->setCounterIdList(id, CounterType::APS_STATUS);
 }
 
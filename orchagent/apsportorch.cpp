@@ -22,8 +22,6 @@ using namespace std;
 using namespace swss;
 
 extern FlexCounterOrch *gFlexCounterOrch;
-extern std::unordered_set<std::string> apsport_counter_ids_status;
-extern std::unordered_set<std::string> apsport_counter_ids_gauge;
 
 vector<otai_attr_id_t> g_apsport_cfg_attrs =
 {
@@ -54,7 +52,7 @@ ApsportOrch::ApsportOrch(DBConnector *db, const vector<string> &table_names)
 
 void ApsportOrch::setFlexCounter(otai_object_id_t id, vector<otai_attribute_t> &attrs)
 {
-    gFlexCounterOrch->getStatusGroup()->setCounterIdList(id, CounterType::APSPORT_STATUS, apsport_counter_ids_status);
-    gFlexCounterOrch->getGaugeGroup()->setCounterIdList(id, CounterType::APSPORT_GAUGE, apsport_counter_ids_gauge);
+    gFlexCounterOrch->setCounterIdList(id, CounterType::APSPORT_STATUS);
+    gFlexCounterOrch->setCounterIdList(id, CounterType::APSPORT_GAUGE);
 }
 
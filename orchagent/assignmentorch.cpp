@@ -22,7 +22,6 @@ using namespace std;
 using namespace swss;
 
 extern FlexCounterOrch* gFlexCounterOrch;
-extern std::unordered_set<std::string> assignment_counter_ids_status;
 
 vector<otai_attr_id_t> g_assignment_cfg_attrs =
 {
@@ -57,6 +56,6 @@ AssignmentOrch::AssignmentOrch(DBConnector* db, const vector<string>& table_name
 
 void AssignmentOrch::setFlexCounter(otai_object_id_t id, vector<otai_attribute_t> &attrs)
 {
-    gFlexCounterOrch->getStatusGroup()->setCounterIdList(id, CounterType::ASSIGNMENT_STATUS, assignment_counter_ids_status);
+    gFlexCounterOrch->setCounterIdList(id, CounterType::ASSIGNMENT_STATUS);
 }
 
@@ -22,8 +22,6 @@ using namespace std;
 using namespace swss;
 
 extern FlexCounterOrch *gFlexCounterOrch;
-extern std::unordered_set<std::string> attenuator_counter_ids_status;
-extern std::unordered_set<std::string> attenuator_counter_ids_gauge;
 
 vector<otai_attr_id_t> g_attenuator_cfg_attrs =
 {
@@ -60,7 +58,7 @@ AttenuatorOrch::AttenuatorOrch(DBConnector *db, const vector<string> &table_name
 
 void AttenuatorOrch::setFlexCounter(otai_object_id_t id, vector<otai_attribute_t> &attrs)
 {
-    gFlexCounterOrch->getStatusGroup()->setCounterIdList(id, CounterType::ATTENUATOR_STATUS, attenuator_counter_ids_status);
-    gFlexCounterOrch->getGaugeGroup()->setCounterIdList(id, CounterType::ATTENUATOR_GAUGE, attenuator_counter_ids_gauge);
+    gFlexCounterOrch->setCounterIdList(id, CounterType::ATTENUATOR_STATUS);
+    gFlexCounterOrch->setCounterIdList(id, CounterType::ATTENUATOR_GAUGE);
 }
 
@@ -0,0 +1,89 @@
+/**
+ * Copyright (c) 2023 Alibaba Group Holding Limited
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABILITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ */
+
+#include "dbconnectorpool.h"
+#include "logger.h"
+
+using namespace std;
+using namespace swss;
+
+map<string, DBConnectorPool::Entry> DBConnectorPool::m_entries;
+
+DBConnectorPool::Entry &DBConnectorPool::getEntry(const string &db_name)
+{
+    return m_entries[db_name];
+}
+
+shared_ptr<DBConnector> DBConnectorPool::getConnector(const string &db_name)
+{
+    SWSS_LOG_ENTER();
+
+    Entry &entry = getEntry(db_name);
+    if (!entry.connector)
+    {
+        entry.connector = make_shared<DBConnector>(db_name, 0);
+        SWSS_LOG_NOTICE("Opened shared connection to %s", db_name.c_str());
+    }
+
+    entry.connectorRequests++;
+
+    return entry.connector;
+}
+
+RedisPipeline *DBConnectorPool::getPipeline(const string &db_name, const string &writer)
+{
+    SWSS_LOG_ENTER();
+
+    Entry &entry = getEntry(db_name);
+    auto &pipeline = entry.pipelines[writer];
+    if (!pipeline)
+    {
+        /* RedisPipeline opens its own connection from the connector */
+        if (!entry.connector)
+        {
+            entry.connector = make_shared<DBConnector>(db_name, 0);
+        }
+        pipeline = unique_ptr<RedisPipeline>(new RedisPipeline(entry.connector.get()));
+        SWSS_LOG_NOTICE("Opened %s pipeline to %s", writer.c_str(), db_name.c_str());
+    }
+
+    entry.pipelineRequests++;
+
+    return pipeline.get();
+}
+
+void DBConnectorPool::getStats(vector<FieldValueTuple> &fvs)
+{
+    uint64_t connections = 0;
+    uint64_t requests = 0;
+
+    for (const auto &it : m_entries)
+    {
+        const Entry &entry = it.second;
+        uint64_t count = (entry.connector ? 1 : 0) + entry.pipelines.size();
+
+        connections += count;
+        requests += entry.connectorRequests + entry.pipelineRequests;
+
+        fvs.emplace_back(it.first + "|connections", to_string(count));
+        fvs.emplace_back(it.first + "|connector-users", to_string(entry.connectorRequests));
+        fvs.emplace_back(it.first + "|pipeline-users", to_string(entry.pipelineRequests));
+    }
+
+    fvs.emplace_back("connections", to_string(connections));
+    fvs.emplace_back("users", to_string(requests));
+}
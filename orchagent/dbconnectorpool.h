@@ -0,0 +1,44 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "dbconnector.h"
+#include "redispipeline.h"
+
+// DBConnectorPool hands out one DBConnector per database to all the
+// components of the process, instead of each orch and flex counter group
+// opening its own connections, and one RedisPipeline per database and
+// logical writer.
+//
+// Orchagent runs its event loop in a single thread, so the shared
+// connections are used without locking. A pipeline is meant for the
+// buffered tables of one write-heavy writer, which flushes it before
+// returning to the event loop. Its commands are then never held back behind
+// or sent ahead of the direct writes of other components to the same
+// tables. Writers which run one at a time and flush before returning, like
+// the bulk creation of all the orchs, may share a pipeline.
+class DBConnectorPool
+{
+public:
+    static std::shared_ptr<swss::DBConnector> getConnector(const std::string &db_name);
+
+    static swss::RedisPipeline *getPipeline(const std::string &db_name, const std::string &writer);
+
+    static void getStats(std::vector<swss::FieldValueTuple> &fvs);
+
+private:
+    struct Entry
+    {
+        std::shared_ptr<swss::DBConnector> connector;
+        std::map<std::string, std::unique_ptr<swss::RedisPipeline>> pipelines;
+        uint64_t connectorRequests = 0;
+        uint64_t pipelineRequests = 0;
+    };
+
+    static Entry &getEntry(const std::string &db_name);
+
+    static std::map<std::string, Entry> m_entries;
+};
@@ -25,10 +25,20 @@
 #include "subscriberstatetable.h"
 #include "notifications.h"
 #include "orchfsm.h"
+#include "otainotificationorch.h"
+#include "flexcounterorch.h"
+#include "linecardorch.h"
+#include "dbconnectorpool.h"
+#include "latencytracer.h"
+#include "otaiapistats.h"
 
 using namespace std;
 using namespace swss;
 
+extern OtaiNotificationOrch *gOtaiNotificationOrch;
+extern FlexCounterOrch *gFlexCounterOrch;
+extern LinecardOrch *gLinecardOrch;
+
 DiagOrch::DiagOrch(swss::DBConnector *db, const std::vector<std::string> &table_names):
     Orch(db, table_names),
     m_db(db)
@@ -44,6 +54,88 @@ DiagOrch::~DiagOrch()
 {
 }
 
+void DiagOrch::setOrchList(const std::vector<Orch *> &orch_list)
+{
+    m_orchList = orch_list;
+}
+
+void DiagOrch::getSchedulerStats(std::vector<swss::FieldValueTuple> &fvs)
+{
+    uint64_t drains = 0;
+    uint64_t skipped = 0;
+    uint64_t dirty = 0;
+
+    for (auto o : m_orchList)
+    {
+        drains += o->getDrainCount();
+        skipped += o->getSkippedDrainCount();
+        if (o->hasDirtyConsumers())
+        {
+            dirty++;
+        }
+    }
+
+    fvs.emplace_back("drains", to_string(drains));
+    fvs.emplace_back("skipped-drains", to_string(skipped));
+    fvs.emplace_back("dirty-orchs", to_string(dirty));
+    fvs.emplace_back("fsm-wakeups", to_string(OrchFSM::getWakeupCount()));
+}
+
+void DiagOrch::getAttrSetStats(std::vector<swss::FieldValueTuple> &fvs)
+{
+    uint64_t applied = 0;
+    uint64_t elided = 0;
+
+    for (auto o : m_orchList)
+    {
+        auto object_orch = dynamic_cast<OtaiObjectOrch *>(o);
+        if (object_orch == NULL)
+        {
+            continue;
+        }
+
+        applied += object_orch->getAppliedSetCount();
+        elided += object_orch->getElidedSetCount();
+
+        fvs.emplace_back(object_orch->getObjectName(),
+                         "applied=" + to_string(object_orch->getAppliedSetCount()) +
+                         ",elided=" + to_string(object_orch->getElidedSetCount()));
+    }
+
+    fvs.emplace_back("applied", to_string(applied));
+    fvs.emplace_back("elided", to_string(elided));
+}
+
+void DiagOrch::getPresenceStats(std::vector<swss::FieldValueTuple> &fvs)
+{
+    for (auto o : m_orchList)
+    {
+        auto object_orch = dynamic_cast<OtaiObjectOrch *>(o);
+        if (object_orch == NULL)
+        {
+            continue;
+        }
+
+        object_orch->getPresenceStats(fvs);
+    }
+}
+
+void DiagOrch::getWarmRestartStats(std::vector<swss::FieldValueTuple> &fvs)
+{
+    gLinecardOrch->getWarmRestartSummary(fvs);
+
+    for (auto o : m_orchList)
+    {
+        auto object_orch = dynamic_cast<OtaiObjectOrch *>(o);
+        if (object_orch == NULL)
+        {
+            continue;
+        }
+
+        object_orch->getWarmRestartStats(fvs);
+    }
+}
+
 void DiagOrch::doTask(Consumer& consumer)
 {
     SWSS_LOG_ENTER();
@@ -88,6 +180,138 @@ void DiagOrch::doTask(NotificationConsumer& consumer)
             op = "SUCCESS";
             reply.send(op, data, fvs);
         }
+        else if (op == "scheduler")
+        {
+            NotificationProducer reply(m_db, "SWSS_DIAG_REPLY");
+            std::vector<swss::FieldValueTuple> fvs;
+
+            getSchedulerStats(fvs);
+
+            op = "SUCCESS";
+            reply.send(op, data, fvs);
+        }
+        else if (op == "attr-sets")
+        {
+            NotificationProducer reply(m_db, "SWSS_DIAG_REPLY");
+            std::vector<swss::FieldValueTuple> fvs;
+
+            getAttrSetStats(fvs);
+
+            op = "SUCCESS";
+            reply.send(op, data, fvs);
+        }
+        else if (op == "notifications")
+        {
+            NotificationProducer reply(m_db, "SWSS_DIAG_REPLY");
+            std::vector<swss::FieldValueTuple> fvs;
+
+            gOtaiNotificationOrch->getStats(fvs);
+
+            op = "SUCCESS";
+            reply.send(op, data, fvs);
+        }
+        else if (op == "presence")
+        {
+            NotificationProducer reply(m_db, "SWSS_DIAG_REPLY");
+            std::vector<swss::FieldValueTuple> fvs;
+
+            getPresenceStats(fvs);
+
+            op = "SUCCESS";
+            reply.send(op, data, fvs);
+        }
+        else if (op == "flex-counters")
+        {
+            NotificationProducer reply(m_db, "SWSS_DIAG_REPLY");
+            std::vector<swss::FieldValueTuple> fvs;
+
+            gFlexCounterOrch->getStats(fvs);
+
+            op = "SUCCESS";
+            reply.send(op, data, fvs);
+        }
+        else if (op == "retries")
+        {
+            NotificationProducer reply(m_db, "SWSS_DIAG_REPLY");
+            std::vector<swss::FieldValueTuple> fvs;
+
+            for (auto o : m_orchList)
+            {
+                o->getRetryStats(fvs);
+            }
+
+            op = "SUCCESS";
+            reply.send(op, data, fvs);
+        }
+        else if (op == "connections")
+        {
+            NotificationProducer reply(m_db, "SWSS_DIAG_REPLY");
+            std::vector<swss::FieldValueTuple> fvs;
+
+            DBConnectorPool::getStats(fvs);
+
+            op = "SUCCESS";
+            reply.send(op, data, fvs);
+        }
+        else if (op == "latency")
+        {
+            NotificationProducer reply(m_db, "SWSS_DIAG_REPLY");
+            std::vector<swss::FieldValueTuple> fvs;
+
+            LatencyTracer::getInstance().getStats(fvs);
+
+            op = "SUCCESS";
+            reply.send(op, data, fvs);
+        }
+        else if (op == "latency-slow")
+        {
+            NotificationProducer reply(m_db, "SWSS_DIAG_REPLY");
+            std::vector<swss::FieldValueTuple> fvs;
+            uint64_t threshold_ms = LATENCY_DEFAULT_SLOW_MS;
+
+            for (auto &fv : values)
+            {
+                if (fvField(fv) == "threshold-ms")
+                {
+                    threshold_ms = strtoull(fvValue(fv).c_str(), NULL, 10);
+                }
+            }
+
+            LatencyTracer::getInstance().getSlowRecords(threshold_ms, fvs);
+
+            op = "SUCCESS";
+            reply.send(op, data, fvs);
+        }
+        else if (op == "otai-api")
+        {
+            NotificationProducer reply(m_db, "SWSS_DIAG_REPLY");
+            std::vector<swss::FieldValueTuple> fvs;
+
+            OtaiApiStats::getInstance().getStats(fvs);
+
+            op = "SUCCESS";
+            reply.send(op, data, fvs);
+        }
+        else if (op == "otai-slow")
+        {
+            NotificationProducer reply(m_db, "SWSS_DIAG_REPLY");
+            std::vector<swss::FieldValueTuple> fvs;
+
+            OtaiApiStats::getInstance().getSlowCalls(fvs);
+
+            op = "SUCCESS";
+            reply.send(op, data, fvs);
+        }
+        else if (op == "warm-restart")
+        {
+            NotificationProducer reply(m_db, "SWSS_DIAG_REPLY");
+            std::vector<swss::FieldValueTuple> fvs;
+
+            getWarmRestartStats(fvs);
+
+            op = "SUCCESS";
+            reply.send(op, data, fvs);
+        }
     }
 }
 
@@ -10,11 +10,17 @@ class DiagOrch : public Orch
 public:
     DiagOrch(swss::DBConnector *db, const std::vector<std::string> &table_names);
     ~DiagOrch();
+    void setOrchList(const std::vector<Orch *> &orch_list);
 private:
     void doTask(Consumer& consumer);
     swss::NotificationConsumer* m_diag_consumer;
     void doTask(swss::NotificationConsumer& consumer);
     swss::DBConnector* m_db;
+    std::vector<Orch *> m_orchList;
+    void getSchedulerStats(std::vector<swss::FieldValueTuple> &fvs);
+    void getAttrSetStats(std::vector<swss::FieldValueTuple> &fvs);
+    void getPresenceStats(std::vector<swss::FieldValueTuple> &fvs);
+    void getWarmRestartStats(std::vector<swss::FieldValueTuple> &fvs);
 };
 
 
@@ -23,8 +23,6 @@ using namespace swss;
 
 extern otai_object_id_t gLinecardId;
 extern FlexCounterOrch *gFlexCounterOrch;
-extern std::unordered_set<std::string> ethernet_counter_ids_counter;
-extern std::unordered_set<std::string> ethernet_counter_ids_status;
 
 vector<otai_attr_id_t> g_ethernet_cfg_attrs =
 {
@@ -62,12 +60,11 @@ EthernetOrch::EthernetOrch(DBConnector *db, std::vector<TableConnector>& connect
 
 void EthernetOrch::setFlexCounter(otai_object_id_t id, vector<otai_attribute_t> &attrs)
 {            
-    gFlexCounterOrch->getCounterGroup()->setCounterIdList(id, CounterType::ETHERNET_COUNTER, ethernet_counter_ids_counter);
-    gFlexCounterOrch->getStatusGroup()->setCounterIdList(id, CounterType::ETHERNET_STATUS, ethernet_counter_ids_status);
+    gFlexCounterOrch->setCounterIdList(id, CounterType::ETHERNET_COUNTER);
+    gFlexCounterOrch->setCounterIdList(id, CounterType::ETHERNET_STATUS);
 }
 
 void EthernetOrch::clearFlexCounter(otai_object_id_t id, string key)
 {
-    gFlexCounterOrch->getCounterGroup()->clearCounterIdList(id);
-    gFlexCounterOrch->getStatusGroup()->clearCounterIdList(id);
+    gFlexCounterOrch->clearCounterIdList(id);
 }
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "selectableevent.h"
+#include "orch.h"
+
+namespace swss {
+
+class ExecutableEvent : public Executor
+{
+public:
+    ExecutableEvent(swss::SelectableEvent *event, Orch *orch, const std::string &name)
+        : Executor(event, orch, name)
+    {
+    }
+
+    swss::SelectableEvent *getSelectableEvent()
+    {
+        return static_cast<swss::SelectableEvent *>(getSelectable());
+    }
+
+    void execute()
+    {
+        m_orch->doTask(*getSelectableEvent());
+    }
+};
+
+}
@@ -1,11 +1,15 @@
 #include "flex_counter_manager.h"
 
 #include <vector>
+#include <chrono>
 
 #include "schema.h"
 #include "rediscommand.h"
+#include "redisreply.h"
+#include "redispipeline.h"
 #include "logger.h"
 #include "otai_serialize.h"
+#include "dbconnectorpool.h"
 
 using std::shared_ptr;
 using std::string;
@@ -15,11 +19,16 @@ using std::vector;
 using swss::DBConnector;
 using swss::FieldValueTuple;
 using swss::ProducerTable;
+using swss::RedisCommand;
+using swss::RedisPipeline;
+using swss::RedisReply;
 using swss::Table;
 
 const string FLEX_COUNTER_ENABLE("enable");
 const string FLEX_COUNTER_DISABLE("disable");
 
+#define FLEX_COUNTER_SCAN_COUNT 1000
+
 const unordered_map<StatsMode, string> FlexCounterManager::stats_mode_lookup =
 {
     { StatsMode::STATS_MODE_COUNTER, "STATS_MODE_COUNTER" },
@@ -33,121 +42,230 @@ const unordered_map<bool, string> FlexCounterManager::status_lookup =
     { true,  FLEX_COUNTER_ENABLE }
 };
 
-const unordered_map<CounterType, string> FlexCounterManager::counter_id_field_lookup =
+// counter_type_info follows the order of CounterType, so it is indexed by the
+// counter type. INTERFACE_GAUGE has no id list in FLEX_COUNTER_DB.
+static constexpr CounterTypeInfo counter_type_info[] =
 {
-    { CounterType::LINECARD_STATUS,  OT_LINECARD_STATUS_ID_LIST },
-    { CounterType::LINECARD_GAUGE,   OT_LINECARD_GAUGE_ID_LIST },
-    { CounterType::LINECARD_COUNTER, OT_LINECARD_COUNTER_ID_LIST },
+    { CounterType::LINECARD_STATUS,     "LINECARD_COUNTER_ID_LIST_STATUS",       OT_LINECARD_STATUS_ID_LIST,      StatsMode::STATS_MODE_STATUS,  OTAI_OBJECT_TYPE_LINECARD },
+    { CounterType::LINECARD_GAUGE,      "LINECARD_COUNTER_ID_LIST_GAUGE",        OT_LINECARD_GAUGE_ID_LIST,       StatsMode::STATS_MODE_GAUGE,   OTAI_OBJECT_TYPE_LINECARD },
+    { CounterType::LINECARD_COUNTER,    "LINECARD_COUNTER_ID_LIST_COUNTER",      OT_LINECARD_COUNTER_ID_LIST,     StatsMode::STATS_MODE_COUNTER, OTAI_OBJECT_TYPE_LINECARD },
 
-    { CounterType::PORT_STATUS,   OT_PORT_STATUS_ID_LIST },
-    { CounterType::PORT_GAUGE,    OT_PORT_GAUGE_ID_LIST },
-    { CounterType::INPORT_GAUGE,  OT_INPORT_GAUGE_ID_LIST },
-    { CounterType::OUTPORT_GAUGE, OT_OUTPORT_GAUGE_ID_LIST },
+    { CounterType::PORT_STATUS,         "PORT_COUNTER_ID_LIST_STATUS",           OT_PORT_STATUS_ID_LIST,          StatsMode::STATS_MODE_STATUS,  OTAI_OBJECT_TYPE_PORT },
+    { CounterType::PORT_GAUGE,          "PORT_COUNTER_ID_LIST_GAUGE",            OT_PORT_GAUGE_ID_LIST,           StatsMode::STATS_MODE_GAUGE,   OTAI_OBJECT_TYPE_PORT },
+    { CounterType::INPORT_GAUGE,        "INPORT_COUNTER_ID_LIST_GAUGE",          OT_INPORT_GAUGE_ID_LIST,         StatsMode::STATS_MODE_GAUGE,   OTAI_OBJECT_TYPE_PORT },
+    { CounterType::OUTPORT_GAUGE,       "OUTPORT_COUNTER_ID_LIST_GAUGE",         OT_OUTPORT_GAUGE_ID_LIST,        StatsMode::STATS_MODE_GAUGE,   OTAI_OBJECT_TYPE_PORT },
 
-    { CounterType::TRANSCEIVER_STATUS, OT_TRANSCEIVER_STATUS_ID_LIST },
-    { CounterType::TRANSCEIVER_GAUGE,  OT_TRANSCEIVER_GAUGE_ID_LIST },
-    { CounterType::TRANSCEIVER_COUNTER,OT_TRANSCEIVER_COUNTER_ID_LIST },
+    { CounterType::TRANSCEIVER_STATUS,  "TRANSCEIVER_COUNTER_ID_LIST_STATUS",    OT_TRANSCEIVER_STATUS_ID_LIST,   StatsMode::STATS_MODE_STATUS,  OTAI_OBJECT_TYPE_TRANSCEIVER },
+    { CounterType::TRANSCEIVER_GAUGE,   "TRANSCEIVER_COUNTER_ID_LIST_GAUGE",     OT_TRANSCEIVER_GAUGE_ID_LIST,    StatsMode::STATS_MODE_GAUGE,   OTAI_OBJECT_TYPE_TRANSCEIVER },
+    { CounterType::TRANSCEIVER_COUNTER, "TRANSCEIVER_COUNTER_ID_LIST_COUNTER",   OT_TRANSCEIVER_COUNTER_ID_LIST,  StatsMode::STATS_MODE_COUNTER, OTAI_OBJECT_TYPE_TRANSCEIVER },
 
-    { CounterType::LOGICALCH_STATUS,   OT_LOGICALCH_STATUS_ID_LIST },
-    { CounterType::LOGICALCH_COUNTER,  OT_LOGICALCH_COUNTER_ID_LIST },
+    { CounterType::LOGICALCH_COUNTER,   "LOGICALCH_COUNTER_ID_LIST_COUNTER",     OT_LOGICALCH_COUNTER_ID_LIST,    StatsMode::STATS_MODE_COUNTER, OTAI_OBJECT_TYPE_LOGICALCHANNEL },
+    { CounterType::LOGICALCH_STATUS,    "LOGICALCH_COUNTER_ID_LIST_STATUS",      OT_LOGICALCH_STATUS_ID_LIST,     StatsMode::STATS_MODE_STATUS,  OTAI_OBJECT_TYPE_LOGICALCHANNEL },
 
-    { CounterType::OTN_STATUS,         OT_OTN_STATUS_ID_LIST },
-    { CounterType::OTN_GAUGE,          OT_OTN_GAUGE_ID_LIST },
-    { CounterType::OTN_COUNTER,        OT_OTN_COUNTER_ID_LIST },
+    { CounterType::OTN_STATUS,          "OTN_COUNTER_ID_LIST_STATUS",            OT_OTN_STATUS_ID_LIST,           StatsMode::STATS_MODE_STATUS,  OTAI_OBJECT_TYPE_OTN },
+    { CounterType::OTN_GAUGE,           "OTN_COUNTER_ID_LIST_GAUGE",             OT_OTN_GAUGE_ID_LIST,            StatsMode::STATS_MODE_GAUGE,   OTAI_OBJECT_TYPE_OTN },
+    { CounterType::OTN_COUNTER,         "OTN_COUNTER_ID_LIST_COUNTER",           OT_OTN_COUNTER_ID_LIST,          StatsMode::STATS_MODE_COUNTER, OTAI_OBJECT_TYPE_OTN },
 
-    { CounterType::ETHERNET_STATUS,    OT_ETHERNET_STATUS_ID_LIST },
-    { CounterType::ETHERNET_COUNTER,   OT_ETHERNET_COUNTER_ID_LIST },
+    { CounterType::ETHERNET_STATUS,     "ETHERNET_COUNTER_ID_LIST_STATUS",       OT_ETHERNET_STATUS_ID_LIST,      StatsMode::STATS_MODE_STATUS,  OTAI_OBJECT_TYPE_ETHERNET },
+    { CounterType::ETHERNET_COUNTER,    "ETHERNET_COUNTER_ID_LIST_COUNTER",      OT_ETHERNET_COUNTER_ID_LIST,     StatsMode::STATS_MODE_COUNTER, OTAI_OBJECT_TYPE_ETHERNET },
 
-    { CounterType::PHYSICALCH_STATUS,  OT_PHYSICALCH_STATUS_ID_LIST },
-    { CounterType::PHYSICALCH_GAUGE,   OT_PHYSICALCH_GAUGE_ID_LIST },
-    { CounterType::PHYSICALCH_COUNTER, OT_PHYSICALCH_COUNTER_ID_LIST },
+    { CounterType::PHYSICALCH_STATUS,   "PHYSICALCH_COUNTER_ID_LIST_STATUS",     OT_PHYSICALCH_STATUS_ID_LIST,    StatsMode::STATS_MODE_STATUS,  OTAI_OBJECT_TYPE_PHYSICALCHANNEL },
+    { CounterType::PHYSICALCH_GAUGE,    "PHYSICALCH_COUNTER_ID_LIST_GAUGE",      OT_PHYSICALCH_GAUGE_ID_LIST,     StatsMode::STATS_MODE_GAUGE,   OTAI_OBJECT_TYPE_PHYSICALCHANNEL },
+    { CounterType::PHYSICALCH_COUNTER,  "PHYSICALCH_COUNTER_ID_LIST_COUNTER",    OT_PHYSICALCH_COUNTER_ID_LIST,   StatsMode::STATS_MODE_COUNTER, OTAI_OBJECT_TYPE_PHYSICALCHANNEL },
 
-    { CounterType::OPTICALCH_STATUS,  OT_OPTICALCH_STATUS_ID_LIST },
-    { CounterType::OPTICALCH_GAUGE,   OT_OPTICALCH_GAUGE_ID_LIST },
-    { CounterType::OPTICALCH_COUNTER, OT_OPTICALCH_COUNTER_ID_LIST },
+    { CounterType::OPTICALCH_STATUS,    "OPTICALCH_COUNTER_ID_LIST_STATUS",      OT_OPTICALCH_STATUS_ID_LIST,     StatsMode::STATS_MODE_STATUS,  OTAI_OBJECT_TYPE_OCH },
+    { CounterType::OPTICALCH_GAUGE,     "OPTICALCH_COUNTER_ID_LIST_GAUGE",       OT_OPTICALCH_GAUGE_ID_LIST,      StatsMode::STATS_MODE_GAUGE,   OTAI_OBJECT_TYPE_OCH },
+    { CounterType::OPTICALCH_COUNTER,   "OPTICALCH_COUNTER_ID_LIST_COUNTER",     OT_OPTICALCH_COUNTER_ID_LIST,    StatsMode::STATS_MODE_COUNTER, OTAI_OBJECT_TYPE_OCH },
 
-    { CounterType::LLDP_STATUS, OT_LLDP_STATUS_ID_LIST },
+    { CounterType::LLDP_STATUS,         "LLDP_COUNTER_ID_LIST_STATUS",           OT_LLDP_STATUS_ID_LIST,          StatsMode::STATS_MODE_STATUS,  OTAI_OBJECT_TYPE_LLDP },
 
-    { CounterType::ASSIGNMENT_STATUS, OT_ASSIGNMENT_STATUS_ID_LIST },
+    { CounterType::ASSIGNMENT_STATUS,   "ASSIGNMENT_COUNTER_ID_LIST_STATUS",     OT_ASSIGNMENT_STATUS_ID_LIST,    StatsMode::STATS_MODE_STATUS,  OTAI_OBJECT_TYPE_ASSIGNMENT },
 
-    { CounterType::INTERFACE_STATUS,  OT_INTERFACE_STATUS_ID_LIST },
+    { CounterType::INTERFACE_STATUS,    "INTERFACE_COUNTER_ID_LIST_STATUS",      OT_INTERFACE_STATUS_ID_LIST,     StatsMode::STATS_MODE_STATUS,  OTAI_OBJECT_TYPE_INTERFACE },
+    { CounterType::INTERFACE_GAUGE,     NULL,                                    NULL,                            StatsMode::STATS_MODE_GAUGE,   OTAI_OBJECT_TYPE_INTERFACE },
+    { CounterType::INTERFACE_COUNTER,   "INTERFACE_COUNTER_ID_LIST_COUNTER",     OT_INTERFACE_COUNTER_ID_LIST,    StatsMode::STATS_MODE_COUNTER, OTAI_OBJECT_TYPE_INTERFACE },
 
-    { CounterType::INTERFACE_COUNTER, OT_INTERFACE_COUNTER_ID_LIST },
+    { CounterType::OA_STATUS,           "OA_COUNTER_ID_LIST_STATUS",             OT_OA_STATUS_ID_LIST,            StatsMode::STATS_MODE_STATUS,  OTAI_OBJECT_TYPE_OA },
+    { CounterType::OA_GAUGE,            "OA_COUNTER_ID_LIST_GAUGE",              OT_OA_GAUGE_ID_LIST,             StatsMode::STATS_MODE_GAUGE,   OTAI_OBJECT_TYPE_OA },
 
-    { CounterType::OA_STATUS, OT_OA_STATUS_ID_LIST },
-    { CounterType::OA_GAUGE, OT_OA_GAUGE_ID_LIST },
+    { CounterType::OSC_STATUS,          "OSC_COUNTER_ID_LIST_STATUS",            OT_OSC_STATUS_ID_LIST,           StatsMode::STATS_MODE_STATUS,  OTAI_OBJECT_TYPE_OSC },
+    { CounterType::OSC_GAUGE,           "OSC_COUNTER_ID_LIST_GAUGE",             OT_OSC_GAUGE_ID_LIST,            StatsMode::STATS_MODE_GAUGE,   OTAI_OBJECT_TYPE_OSC },
 
-    { CounterType::OSC_STATUS, OT_OSC_STATUS_ID_LIST },
-    { CounterType::OSC_GAUGE, OT_OSC_GAUGE_ID_LIST },
+    { CounterType::APS_STATUS,          "APS_COUNTER_ID_LIST_STATUS",            OT_APS_STATUS_ID_LIST,           StatsMode::STATS_MODE_STATUS,  OTAI_OBJECT_TYPE_APS },
 
-    { CounterType::APS_STATUS, OT_APS_STATUS_ID_LIST },
+    { CounterType::APSPORT_STATUS,      "APSPORT_COUNTER_ID_LIST_STATUS",        OT_APSPORT_STATUS_ID_LIST,       StatsMode::STATS_MODE_STATUS,  OTAI_OBJECT_TYPE_APSPORT },
+    { CounterType::APSPORT_GAUGE,       "APSPORT_COUNTER_ID_LIST_GAUGE",         OT_APSPORT_GAUGE_ID_LIST,        StatsMode::STATS_MODE_GAUGE,   OTAI_OBJECT_TYPE_APSPORT },
 
-    { CounterType::APSPORT_STATUS, OT_APSPORT_STATUS_ID_LIST },
-    { CounterType::APSPORT_GAUGE, OT_APSPORT_GAUGE_ID_LIST },
+    { CounterType::ATTENUATOR_STATUS,   "ATTENUATOR_COUNTER_ID_LIST_STATUS",     OT_ATTENUATOR_STATUS_ID_LIST,    StatsMode::STATS_MODE_STATUS,  OTAI_OBJECT_TYPE_ATTENUATOR },
+    { CounterType::ATTENUATOR_GAUGE,    "ATTENUATOR_COUNTER_ID_LIST_GAUGE",      OT_ATTENUATOR_GAUGE_ID_LIST,     StatsMode::STATS_MODE_GAUGE,   OTAI_OBJECT_TYPE_ATTENUATOR },
 
-    { CounterType::ATTENUATOR_STATUS, OT_ATTENUATOR_STATUS_ID_LIST },
-    { CounterType::ATTENUATOR_GAUGE, OT_ATTENUATOR_GAUGE_ID_LIST },
+    { CounterType::OCM_STATUS,          "OCM_COUNTER_ID_LIST_STATUS",            OT_OCM_STATUS_ID_LIST,           StatsMode::STATS_MODE_STATUS,  OTAI_OBJECT_TYPE_OCM },
 
-    { CounterType::OCM_STATUS, OT_OCM_STATUS_ID_LIST },
-    { CounterType::OTDR_STATUS, OT_OTDR_STATUS_ID_LIST },
+    { CounterType::OTDR_STATUS,         "OTDR_COUNTER_ID_LIST_STATUS",           OT_OTDR_STATUS_ID_LIST,          StatsMode::STATS_MODE_STATUS,  OTAI_OBJECT_TYPE_OTDR },
 };
 
+static constexpr bool isCounterTypeInfoOrdered(size_t i)
+{
+    return i == COUNTER_TYPE_COUNT ||
+           (static_cast<size_t>(counter_type_info[i].type) == i && isCounterTypeInfoOrdered(i + 1));
+}
+
+static_assert(sizeof(counter_type_info) / sizeof(counter_type_info[0]) == COUNTER_TYPE_COUNT,
+              "counter_type_info must describe every CounterType");
+static_assert(isCounterTypeInfoOrdered(0), "counter_type_info must follow the order of CounterType");
+
+
+std::array<CounterStatSet, COUNTER_TYPE_COUNT> FlexCounterManager::counter_type_stat_sets;
+std::array<string, COUNTER_TYPE_COUNT> FlexCounterManager::counter_type_stats;
+
 FlexCounterManager::FlexCounterManager(
     const string& group_name,
     const StatsMode stats_mode,
     const uint polling_interval,
-    const bool enabled) :
+    const bool enabled,
+    const bool reconcile) :
     group_name(group_name),
     stats_mode(stats_mode),
     polling_interval(polling_interval),
     enabled(enabled),
-    flex_counter_db(new DBConnector("FLEX_COUNTER_DB", 0)),
+    reconciling(reconcile),
+    flex_counter_db(DBConnectorPool::getConnector("FLEX_COUNTER_DB")),
+    flex_counter_pipeline(DBConnectorPool::getPipeline("FLEX_COUNTER_DB", "flex-counter-" + group_name)),
     flex_counter_group_table(new ProducerTable(flex_counter_db.get(), FLEX_COUNTER_GROUP_TABLE)),
-    flex_counter_table(new ProducerTable(flex_counter_db.get(), FLEX_COUNTER_TABLE))
+    flex_counter_table(new ProducerTable(flex_counter_pipeline, FLEX_COUNTER_TABLE, true))
+{
+    SWSS_LOG_ENTER();
+
+    cleanupFlexCounterTable();
+
+    applyGroupConfiguration();
+
+    SWSS_LOG_DEBUG("Initialized flex counter group '%s'.", group_name.c_str());
+}
+
+FlexCounterManager::~FlexCounterManager()
+{
+    SWSS_LOG_ENTER();
+
+    for (const auto& counter : installed_counters)
+    {
+        flex_counter_table->del(getFlexCounterTableKey(group_name, counter));
+    }
+
+    flex_counter_pipeline->flush();
+
+    flex_counter_group_table->del(group_name);
+
+    SWSS_LOG_DEBUG("Deleted flex counter group '%s'.", group_name.c_str());
+}
+
+// cleanupFlexCounterTable removes the counters left in FLEX_COUNTER_DB by a
+// previous run. Only the keys of this group are scanned, and the deletes are
+// sent in one pipelined batch. In reconcile mode the keys are remembered
+// and only the stale ones are deleted by finishReconcile().
+void FlexCounterManager::cleanupFlexCounterTable()
 {
     SWSS_LOG_ENTER();
 
-    Table table(flex_counter_db.get(), FLEX_COUNTER_TABLE);
     vector<string> keys;
-    table.getKeys(keys);
-    for (auto &k: keys)
+    scanFlexCounterTableKeys(keys);
+
+    if (reconciling)
     {
-        if (k.find(group_name) == std::string::npos)
-        {
-            continue;
-        }        
-        flex_counter_table->del(k);
+        stale_counters.insert(keys.begin(), keys.end());
+
+        SWSS_LOG_NOTICE("Found %zu flex counters of group '%s' to reconcile.",
+            keys.size(), group_name.c_str());
+        return;
     }
 
-    keys.clear();
-    Table table2(flex_counter_db.get(), FLEX_COUNTER_GROUP_TABLE);
-    table2.getKeys(keys);
-    for (auto &k: keys)
+    /* The group is set again by applyGroupConfiguration() */
+    keys.push_back(group_name);
+    deleteFlexCounterTableKeys(keys);
+
+    SWSS_LOG_NOTICE("Removed %zu flex counters of group '%s'.",
+        keys.size() - 1, group_name.c_str());
+}
+
+// scanFlexCounterTableKeys returns the FLEX_COUNTER_TABLE keys of this group,
+// without the table name prefix.
+void FlexCounterManager::scanFlexCounterTableKeys(vector<string>& keys) const
+{
+    SWSS_LOG_ENTER();
+
+    const string separator = flex_counter_table->getTableNameSeparator();
+    const string prefix = string(FLEX_COUNTER_TABLE) + separator;
+    const string pattern = prefix + group_name + separator + "*";
+    string cursor = "0";
+
+    do
     {
-        if (k == group_name)
+        RedisCommand scan;
+        scan.format("SCAN %s MATCH %s COUNT %d", cursor.c_str(), pattern.c_str(), FLEX_COUNTER_SCAN_COUNT);
+
+        RedisReply r(flex_counter_db.get(), scan, REDIS_REPLY_ARRAY);
+        redisReply *reply = r.getContext();
+
+        cursor = string(reply->element[0]->str, reply->element[0]->len);
+
+        redisReply *batch = reply->element[1];
+        for (size_t i = 0; i < batch->elements; i++)
         {
-            flex_counter_group_table->del(k);
-            break;
+            string key(batch->element[i]->str, batch->element[i]->len);
+            keys.push_back(key.substr(prefix.size()));
         }
+    } while (cursor != "0");
+}
+
+// deleteFlexCounterTableKeys deletes the given keys from FLEX_COUNTER_TABLE,
+// or from FLEX_COUNTER_GROUP_TABLE for the group name, in one pipelined
+// batch.
+void FlexCounterManager::deleteFlexCounterTableKeys(const vector<string>& keys) const
+{
+    SWSS_LOG_ENTER();
+
+    if (keys.empty())
+    {
+        return;
     }
 
-    applyGroupConfiguration();
+    ProducerTable counter_table(flex_counter_pipeline, FLEX_COUNTER_TABLE, true);
+    ProducerTable group_table(flex_counter_pipeline, FLEX_COUNTER_GROUP_TABLE, true);
 
-    SWSS_LOG_DEBUG("Initialized flex counter group '%s'.", group_name.c_str());
+    for (const auto& key : keys)
+    {
+        if (key == group_name)
+        {
+            group_table.del(key);
+        }
+        else
+        {
+            counter_table.del(key);
+        }
+    }
+
+    flex_counter_pipeline->flush();
 }
 
-FlexCounterManager::~FlexCounterManager()
+void FlexCounterManager::finishReconcile()
 {
     SWSS_LOG_ENTER();
 
-    for (const auto& counter : installed_counters)
+    if (!reconciling)
     {
-        flex_counter_table->del(getFlexCounterTableKey(group_name, counter));
+        return;
     }
 
-    flex_counter_group_table->del(group_name);
+    flush();
 
-    SWSS_LOG_DEBUG("Deleted flex counter group '%s'.", group_name.c_str());
+    vector<string> keys(stale_counters.begin(), stale_counters.end());
+    deleteFlexCounterTableKeys(keys);
+
+    SWSS_LOG_NOTICE("Reconciled flex counter group '%s', removed %zu stale counters.",
+        group_name.c_str(), keys.size());
+
+    stale_counters.clear();
+    reconciling = false;
 }
 
 void FlexCounterManager::applyGroupConfiguration()
@@ -174,6 +292,7 @@ void FlexCounterManager::updateGroupPollingInterval(
         FieldValueTuple(POLL_INTERVAL_FIELD, std::to_string(polling_interval))
     };
     flex_counter_group_table->set(group_name, field_values);
+    this->polling_interval = polling_interval;
 
     SWSS_LOG_DEBUG("Set polling interval for flex counter group '%s' to %d ms.",
         group_name.c_str(), polling_interval);
@@ -232,8 +351,38 @@ void FlexCounterManager::setCounterIdList(
 {
     SWSS_LOG_ENTER();
 
-    auto counter_type_it = counter_id_field_lookup.find(counter_type);
-    if (counter_type_it == counter_id_field_lookup.end())
+    installCounterIdList(object_id, counter_type, serializeCounterStats(counter_stats));
+}
+
+// setCounterIdList configures a flex counter to poll the stats precomputed
+// for the counter type by serializeCounterTypeStats.
+void FlexCounterManager::setCounterIdList(
+    const otai_object_id_t object_id,
+    const CounterType counter_type)
+{
+    SWSS_LOG_ENTER();
+
+    if (counter_type >= CounterType::COUNTER_TYPE_MAX)
+    {
+        SWSS_LOG_ERROR("Could not update flex counter id list for group '%s': counter type not found.",
+            group_name.c_str());
+        return;
+    }
+
+    installCounterIdList(object_id, counter_type, counter_type_stats[static_cast<size_t>(counter_type)]);
+}
+
+void FlexCounterManager::installCounterIdList(
+    const otai_object_id_t object_id,
+    const CounterType counter_type,
+    const string& serialized_stats)
+{
+    SWSS_LOG_ENTER();
+
+    auto start = std::chrono::steady_clock::now();
+
+    if (counter_type >= CounterType::COUNTER_TYPE_MAX ||
+        counter_type_info[static_cast<size_t>(counter_type)].id_list_field == NULL)
     {
         SWSS_LOG_ERROR("Could not update flex counter id list for group '%s': counter type not found.",
             group_name.c_str());
@@ -242,11 +391,21 @@ void FlexCounterManager::setCounterIdList(
 
     std::vector<swss::FieldValueTuple> field_values =
     {
-        FieldValueTuple(counter_type_it->second, serializeCounterStats(counter_stats))
+        FieldValueTuple(counter_type_info[static_cast<size_t>(counter_type)].id_list_field, serialized_stats)
     };
-    flex_counter_table->set(getFlexCounterTableKey(group_name, object_id), field_values);
+    string key = getFlexCounterTableKey(group_name, object_id);
+    flex_counter_table->set(key, field_values);
     installed_counters.insert(object_id);
 
+    if (reconciling)
+    {
+        stale_counters.erase(key);
+    }
+
+    registered_count++;
+    register_ns += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count());
+
     SWSS_LOG_DEBUG("Updated flex counter id list for object '%" PRIu64 "' in group '%s'.",
         object_id,
         group_name.c_str());
@@ -267,14 +426,130 @@ void FlexCounterManager::clearCounterIdList(const otai_object_id_t object_id)
         return;
     }
 
-    flex_counter_table->del(getFlexCounterTableKey(group_name, object_id));
+    string key = getFlexCounterTableKey(group_name, object_id);
+    flex_counter_table->del(key);
     installed_counters.erase(counter_it);
 
+    if (reconciling)
+    {
+        stale_counters.erase(key);
+    }
+
+    cleared_count++;
+
     SWSS_LOG_DEBUG("Cleared flex counter id list for object '%" PRIu64 "' in group '%s'.",
         object_id,
         group_name.c_str());
 }
 
+void FlexCounterManager::flush()
+{
+    SWSS_LOG_ENTER();
+
+    if (flex_counter_pipeline->size() == 0)
+    {
+        return;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    flex_counter_pipeline->flush();
+
+    flush_count++;
+    flush_ns += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count());
+}
+
+const CounterTypeInfo& FlexCounterManager::getCounterTypeInfo(const CounterType counter_type)
+{
+    return counter_type_info[static_cast<size_t>(counter_type)];
+}
+
+bool FlexCounterManager::findCounterType(const string& json_key, CounterType& counter_type)
+{
+    for (const auto& info : counter_type_info)
+    {
+        if (info.json_key != NULL && json_key == info.json_key)
+        {
+            counter_type = info.type;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// getStatName returns the name of the stat at the given index of the OTAI
+// metadata of the counter type, or NULL past the last stat.
+static const char *getStatName(const CounterTypeInfo& info, size_t index)
+{
+    auto type_info = otai_metadata_get_object_type_info(info.object_type);
+    if (type_info == NULL)
+    {
+        return NULL;
+    }
+
+    if (info.stats_mode == StatsMode::STATS_MODE_STATUS)
+    {
+        return index < type_info->attrmetadatalength ?
+            type_info->attrmetadata[index]->attridname : NULL;
+    }
+
+    if (type_info->statenum == NULL)
+    {
+        return NULL;
+    }
+
+    return index < type_info->statenum->valuescount ?
+        type_info->statenum->valuesnames[index] : NULL;
+}
+
+bool FlexCounterManager::addCounterTypeStat(const CounterType counter_type, const string& stat)
+{
+    SWSS_LOG_ENTER();
+
+    const CounterTypeInfo& info = getCounterTypeInfo(counter_type);
+
+    const char *name;
+    for (size_t i = 0; i < FLEX_COUNTER_MAX_STATS && (name = getStatName(info, i)) != NULL; i++)
+    {
+        if (stat == name)
+        {
+            counter_type_stat_sets[static_cast<size_t>(counter_type)].set(i);
+            return true;
+        }
+    }
+
+    SWSS_LOG_ERROR("Unknown stat %s of %s", stat.c_str(), info.json_key);
+    return false;
+}
+
+void FlexCounterManager::serializeCounterTypeStats()
+{
+    SWSS_LOG_ENTER();
+
+    for (const auto& info : counter_type_info)
+    {
+        const CounterStatSet& stat_set = counter_type_stat_sets[static_cast<size_t>(info.type)];
+        string& stats_string = counter_type_stats[static_cast<size_t>(info.type)];
+
+        stats_string.clear();
+        for (size_t i = 0; i < stat_set.size(); i++)
+        {
+            if (stat_set.test(i))
+            {
+                stats_string.append(getStatName(info, i));
+                stats_string.append(",");
+            }
+        }
+
+        if (!stats_string.empty())
+        {
+            stats_string.pop_back();
+        }
+    }
+}
+
 string FlexCounterManager::getFlexCounterTableKey(
     const string& group_name,
     const otai_object_id_t object_id) const
@@ -286,7 +561,7 @@ string FlexCounterManager::getFlexCounterTableKey(
 
 // serializeCounterStats turns a set of stats into a format suitable for FLEX_COUNTER_DB.
 string FlexCounterManager::serializeCounterStats(
-    const unordered_set<string>& counter_stats) const
+    const unordered_set<string>& counter_stats)
 {
     SWSS_LOG_ENTER();
 
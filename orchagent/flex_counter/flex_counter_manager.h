@@ -1,11 +1,15 @@
 #ifndef ORCHAGENT_FLEX_COUNTER_MANAGER_H
 #define ORCHAGENT_FLEX_COUNTER_MANAGER_H
 
+#include <array>
+#include <bitset>
 #include <string>
 #include <unordered_set>
 #include <unordered_map>
+#include <vector>
 #include "dbconnector.h"
 #include "producertable.h"
+#include "redispipeline.h"
 #include <inttypes.h>
 
 extern "C" {
@@ -76,6 +80,28 @@ enum class CounterType
 
     OCM_STATUS,
     OTDR_STATUS,
+
+    COUNTER_TYPE_MAX,
+};
+
+#define COUNTER_TYPE_COUNT static_cast<size_t>(CounterType::COUNTER_TYPE_MAX)
+
+// A stat is identified by its index in the OTAI metadata of the object type:
+// the attribute list for status counters, the stat enum otherwise.
+#define FLEX_COUNTER_MAX_STATS 512
+
+typedef std::bitset<FLEX_COUNTER_MAX_STATS> CounterStatSet;
+
+// CounterTypeInfo describes a counter type: the key of its stat list in the
+// flexcounter json, the field of its id list in FLEX_COUNTER_TABLE, its stats
+// mode and the OTAI object type its stats are resolved against.
+struct CounterTypeInfo
+{
+    CounterType type;
+    const char *json_key;
+    const char *id_list_field;
+    StatsMode stats_mode;
+    otai_object_type_t object_type;
 };
 
 // FlexCounterManager allows users to manage a group of flex counters.
@@ -90,7 +116,8 @@ public:
         const std::string& group_name,
         const StatsMode stats_mode,
         const uint polling_interval,
-        const bool enabled);
+        const bool enabled,
+        const bool reconcile = false);
 
     FlexCounterManager(const FlexCounterManager&) = delete;
     FlexCounterManager& operator=(const FlexCounterManager&) = delete;
@@ -104,17 +131,57 @@ public:
         const otai_object_id_t object_id,
         const CounterType counter_type,
         const std::unordered_set<std::string>& counter_stats);
+    void setCounterIdList(
+        const otai_object_id_t object_id,
+        const CounterType counter_type);
     void clearCounterIdList(const otai_object_id_t object_id);
 
+    // Registrations are buffered, flush sends them in one pipelined batch.
+    void flush();
+
+    static const CounterTypeInfo& getCounterTypeInfo(const CounterType counter_type);
+    static bool findCounterType(const std::string& json_key, CounterType& counter_type);
+
+    // addCounterTypeStat resolves a stat name against the OTAI metadata and
+    // adds it to the stats polled for all objects of the counter type.
+    static bool addCounterTypeStat(const CounterType counter_type, const std::string& stat);
+
+    // serializeCounterTypeStats precomputes the id list of every counter
+    // type from its stat set, setCounterIdList only copies it.
+    static void serializeCounterTypeStats();
+
+    const std::string& getGroupName() const { return group_name; }
+    StatsMode getStatsMode() const { return stats_mode; }
+    uint getPollingInterval() const { return polling_interval; }
+    bool isInstalled(const otai_object_id_t object_id) const { return installed_counters.count(object_id) != 0; }
+    uint64_t getRegisteredCount() const { return registered_count; }
+    uint64_t getClearedCount() const { return cleared_count; }
+    uint64_t getFlushCount() const { return flush_count; }
+    uint64_t getRegisterNs() const { return register_ns; }
+    uint64_t getFlushNs() const { return flush_ns; }
+
+    // finishReconcile removes the counters found at startup which were not
+    // registered again. It does nothing when the group is not reconciling.
+    void finishReconcile();
+    bool isReconciling() const { return reconciling; }
+
 protected:
     void applyGroupConfiguration();
 
 private:
+    void installCounterIdList(
+        const otai_object_id_t object_id,
+        const CounterType counter_type,
+        const std::string& serialized_stats);
+    void cleanupFlexCounterTable();
+    void scanFlexCounterTableKeys(std::vector<std::string>& keys) const;
+    void deleteFlexCounterTableKeys(const std::vector<std::string>& keys) const;
+
     std::string getFlexCounterTableKey(
         const std::string& group_name,
         const otai_object_id_t object_id) const;
-    std::string serializeCounterStats(
-        const std::unordered_set<std::string>& counter_stats) const;
+    static std::string serializeCounterStats(
+        const std::unordered_set<std::string>& counter_stats);
 
     std::string group_name;
     StatsMode stats_mode;
@@ -122,13 +189,30 @@ private:
     bool enabled;
     std::unordered_set<otai_object_id_t> installed_counters;
 
+    // In reconcile mode the counters found at startup are kept until
+    // finishReconcile(), the ones registered again in the meantime are
+    // removed from stale_counters and thus survive.
+    bool reconciling;
+    std::unordered_set<std::string> stale_counters;
+
+    uint64_t registered_count = 0;
+    uint64_t cleared_count = 0;
+    uint64_t flush_count = 0;
+    uint64_t register_ns = 0;
+    uint64_t flush_ns = 0;
+
     std::shared_ptr<swss::DBConnector> flex_counter_db = nullptr;
+    // Pipeline of this group, so the flush stats are its own, flushed once
+    // per event loop iteration by FlexCounterOrch::flush(), see
+    // DBConnectorPool.
+    swss::RedisPipeline *flex_counter_pipeline = nullptr;
     std::shared_ptr<swss::ProducerTable> flex_counter_group_table = nullptr;
     std::shared_ptr<swss::ProducerTable> flex_counter_table = nullptr;
 
     static const std::unordered_map<StatsMode, std::string> stats_mode_lookup;
     static const std::unordered_map<bool, std::string> status_lookup;
-    static const std::unordered_map<CounterType, std::string> counter_id_field_lookup;
+    static std::array<CounterStatSet, COUNTER_TYPE_COUNT> counter_type_stat_sets;
+    static std::array<std::string, COUNTER_TYPE_COUNT> counter_type_stats;
 };
 
 #endif // ORCHAGENT_FLEX_COUNTER_MANAGER_H
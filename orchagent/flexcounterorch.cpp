@@ -27,136 +27,20 @@
 #include <fstream>
 #include <iostream>
 #include "json.h"
+#include "dbconnectorpool.h"
 
 using namespace std;
 
 extern PortOrch* gPortOrch;
 extern LinecardOrch* gLinecardOrch;
 extern string gFlexcounterJsonFile;
+extern bool gFlexCounterReconcile;
 
-std::unordered_map<std::string, std::string> flexCounterGroupMap =
+static const std::unordered_map<std::string, StatsMode> statsModeMap =
 {
-    {"1S_STAT_GAUGE", STAT_GAUGE_FLEX_COUNTER_GROUP},
-    {"1S_STAT_COUNTER", STAT_COUNTER_COUNTER_FLEX_COUNTER_GROUP},
-    {"1S_STAT_STATUS", STAT_STATUS_COUNTER_FLEX_COUNTER_GROUP},
-};
-
-std::unordered_set<std::string> linecard_counter_ids_status;
-std::unordered_set<std::string> linecard_counter_ids_gauge;
-std::unordered_set<std::string> linecard_counter_ids_counter;
-
-std::unordered_set<std::string> port_counter_ids_status;
-std::unordered_set<std::string> port_counter_ids_gauge;
-std::unordered_set<std::string> inport_counter_ids_gauge;
-std::unordered_set<std::string> outport_counter_ids_gauge;
-
-std::unordered_set<std::string> transceiver_counter_ids_status;
-std::unordered_set<std::string> transceiver_counter_ids_gauge;
-std::unordered_set<std::string> transceiver_counter_ids_counter;
-
-std::unordered_set<std::string> logicalch_counter_ids_status;
-std::unordered_set<std::string> logicalch_counter_ids_counter;
-
-std::unordered_set<std::string> otn_counter_ids_status;
-std::unordered_set<std::string> otn_counter_ids_gauge;
-std::unordered_set<std::string> otn_counter_ids_counter;
-
-std::unordered_set<std::string> ethernet_counter_ids_status;
-std::unordered_set<std::string> ethernet_counter_ids_counter;
-
-std::unordered_set<std::string> physicalch_counter_ids_status;
-std::unordered_set<std::string> physicalch_counter_ids_gauge;
-std::unordered_set<std::string> physicalch_counter_ids_counter;
-
-std::unordered_set<std::string> opticalch_counter_ids_status;
-std::unordered_set<std::string> opticalch_counter_ids_gauge;
-std::unordered_set<std::string> opticalch_counter_ids_counter;
-
-std::unordered_set<std::string> clientport_counter_ids_status;
-
-std::unordered_set<std::string> lldp_counter_ids_status;
-
-std::unordered_set<std::string> assignment_counter_ids_status;
-
-std::unordered_set<std::string> interface_counter_ids_status;
-std::unordered_set<std::string> interface_counter_ids_counter;
-
-std::unordered_set<std::string> oa_counter_ids_status;
-std::unordered_set<std::string> oa_counter_ids_gauge;
-
-std::unordered_set<std::string> osc_counter_ids_status;
-std::unordered_set<std::string> osc_counter_ids_gauge;
-
-std::unordered_set<std::string> aps_counter_ids_status;
-
-std::unordered_set<std::string> apsport_counter_ids_status;
-std::unordered_set<std::string> apsport_counter_ids_gauge;
-
-std::unordered_set<std::string> attenuator_counter_ids_status;
-std::unordered_set<std::string> attenuator_counter_ids_gauge;
-
-std::unordered_set<std::string> ocm_counter_ids_status;
-
-std::unordered_set<std::string> otdr_counter_ids_status;
-
-std::unordered_map<std::string, std::unordered_set<std::string>&> g_flexCounterIds =
-{
-    {"LINECARD_COUNTER_ID_LIST_STATUS",     linecard_counter_ids_status},
-    {"LINECARD_COUNTER_ID_LIST_GAUGE",      linecard_counter_ids_gauge},
-    {"LINECARD_COUNTER_ID_LIST_COUNTER",    linecard_counter_ids_counter},
-
-    {"PORT_COUNTER_ID_LIST_STATUS",         port_counter_ids_status},
-    {"PORT_COUNTER_ID_LIST_GAUGE",          port_counter_ids_gauge},
-    {"INPORT_COUNTER_ID_LIST_GAUGE",        inport_counter_ids_gauge},
-    {"OUTPORT_COUNTER_ID_LIST_GAUGE",       outport_counter_ids_gauge},
-
-    {"TRANSCEIVER_COUNTER_ID_LIST_STATUS",  transceiver_counter_ids_status},
-    {"TRANSCEIVER_COUNTER_ID_LIST_GAUGE",   transceiver_counter_ids_gauge},
-    {"TRANSCEIVER_COUNTER_ID_LIST_COUNTER", transceiver_counter_ids_counter},
-
-    {"LOGICALCH_COUNTER_ID_LIST_STATUS",    logicalch_counter_ids_status},
-    {"LOGICALCH_COUNTER_ID_LIST_COUNTER",   logicalch_counter_ids_counter},
-
-    {"OTN_COUNTER_ID_LIST_STATUS",          otn_counter_ids_status},
-    {"OTN_COUNTER_ID_LIST_GAUGE",           otn_counter_ids_gauge},
-    {"OTN_COUNTER_ID_LIST_COUNTER",         otn_counter_ids_counter},
-
-    {"ETHERNET_COUNTER_ID_LIST_STATUS",     ethernet_counter_ids_status},
-    {"ETHERNET_COUNTER_ID_LIST_COUNTER",    ethernet_counter_ids_counter},
-
-    {"PHYSICALCH_COUNTER_ID_LIST_STATUS",   physicalch_counter_ids_status},
-    {"PHYSICALCH_COUNTER_ID_LIST_GAUGE",    physicalch_counter_ids_gauge},
-    {"PHYSICALCH_COUNTER_ID_LIST_COUNTER",  physicalch_counter_ids_counter},
-
-    {"OPTICALCH_COUNTER_ID_LIST_STATUS",    opticalch_counter_ids_status},
-    {"OPTICALCH_COUNTER_ID_LIST_GAUGE",     opticalch_counter_ids_gauge},
-    {"OPTICALCH_COUNTER_ID_LIST_COUNTER",   opticalch_counter_ids_counter},
-
-    {"LLDP_COUNTER_ID_LIST_STATUS",         lldp_counter_ids_status},
-
-    {"ASSIGNMENT_COUNTER_ID_LIST_STATUS",   assignment_counter_ids_status},
-
-    {"INTERFACE_COUNTER_ID_LIST_STATUS",    interface_counter_ids_status},
-    {"INTERFACE_COUNTER_ID_LIST_COUNTER",   interface_counter_ids_counter},
-
-    {"OA_COUNTER_ID_LIST_STATUS",           oa_counter_ids_status},
-    {"OA_COUNTER_ID_LIST_GAUGE",            oa_counter_ids_gauge},
-
-    {"OSC_COUNTER_ID_LIST_STATUS",          osc_counter_ids_status},
-    {"OSC_COUNTER_ID_LIST_GAUGE",           osc_counter_ids_gauge},
-
-    {"APS_COUNTER_ID_LIST_STATUS",          aps_counter_ids_status},
-
-    {"APSPORT_COUNTER_ID_LIST_STATUS",      apsport_counter_ids_status},
-    {"APSPORT_COUNTER_ID_LIST_GAUGE",       apsport_counter_ids_gauge},
-
-    {"ATTENUATOR_COUNTER_ID_LIST_STATUS",   attenuator_counter_ids_status},
-    {"ATTENUATOR_COUNTER_ID_LIST_GAUGE",    attenuator_counter_ids_gauge},
-
-    {"OCM_COUNTER_ID_LIST_STATUS",          ocm_counter_ids_status},
-
-    {"OTDR_COUNTER_ID_LIST_STATUS",         otdr_counter_ids_status},
-
+    {"STATS_MODE_GAUGE",   StatsMode::STATS_MODE_GAUGE},
+    {"STATS_MODE_COUNTER", StatsMode::STATS_MODE_COUNTER},
+    {"STATS_MODE_STATUS",  StatsMode::STATS_MODE_STATUS},
 };
 
 shared_ptr<vector<KeyOpFieldsValuesTuple>> load_json(string file)
@@ -183,15 +67,33 @@ shared_ptr<vector<KeyOpFieldsValuesTuple>> load_json(string file)
 
 FlexCounterOrch::FlexCounterOrch(DBConnector* db, vector<string>& tableNames) :
     Orch(db, tableNames),
-    m_flexCounterDb(new DBConnector("FLEX_COUNTER_DB", 0)),
+    m_flexCounterDb(DBConnectorPool::getConnector("FLEX_COUNTER_DB")),
     m_flexCounterGroupTable(new ProducerTable(m_flexCounterDb.get(), FLEX_COUNTER_GROUP_TABLE)),
-    m_gaugeManager(STAT_GAUGE_FLEX_COUNTER_GROUP, StatsMode::STATS_MODE_GAUGE, DEFAULT_POLL_TIME, true),
-    m_counterManager(STAT_COUNTER_COUNTER_FLEX_COUNTER_GROUP, StatsMode::STATS_MODE_COUNTER, DEFAULT_POLL_TIME, true),
-    m_statusManager(STAT_STATUS_COUNTER_FLEX_COUNTER_GROUP, StatsMode::STATS_MODE_STATUS, DEFAULT_POLL_TIME, true)
+    m_gaugeManager(STAT_GAUGE_FLEX_COUNTER_GROUP, StatsMode::STATS_MODE_GAUGE, DEFAULT_POLL_TIME, true, gFlexCounterReconcile),
+    m_counterManager(STAT_COUNTER_COUNTER_FLEX_COUNTER_GROUP, StatsMode::STATS_MODE_COUNTER, DEFAULT_POLL_TIME, true, gFlexCounterReconcile),
+    m_statusManager(STAT_STATUS_COUNTER_FLEX_COUNTER_GROUP, StatsMode::STATS_MODE_STATUS, DEFAULT_POLL_TIME, true, gFlexCounterReconcile)
 {
     SWSS_LOG_ENTER();
     m_flexCounterInit = false;
     m_flexCounterGroupInit = false;
+
+    m_managers = { &m_gaugeManager, &m_counterManager, &m_statusManager };
+
+    for (size_t i = 0; i < COUNTER_TYPE_COUNT; i++)
+    {
+        switch (FlexCounterManager::getCounterTypeInfo(static_cast<CounterType>(i)).stats_mode)
+        {
+        case StatsMode::STATS_MODE_GAUGE:
+            m_counterTypeManagers[i] = &m_gaugeManager;
+            break;
+        case StatsMode::STATS_MODE_COUNTER:
+            m_counterTypeManagers[i] = &m_counterManager;
+            break;
+        default:
+            m_counterTypeManagers[i] = &m_statusManager;
+            break;
+        }
+    }
 }
 
 FlexCounterOrch::~FlexCounterOrch(void)
@@ -220,24 +122,13 @@ void FlexCounterOrch::doCounterGroupTask(Consumer& consumer)
         auto data = kfvFieldsValues(t);
         SWSS_LOG_NOTICE("FlexCounterOrch key is %s op is %s", key.c_str(), op.c_str());
 
-        if (!flexCounterGroupMap.count(key))
+        groupPtr = findManager(key);
+        if (groupPtr == NULL)
         {
             SWSS_LOG_NOTICE("Invalid flex counter group input, %s", key.c_str());
             consumer.m_toSync.erase(it++);
             continue;
         }
-        if (strcmp(key.c_str(), "1S_STAT_GAUGE") == 0)
-        {
-            groupPtr = &m_gaugeManager;
-        }
-        else if (strcmp(key.c_str(), "1S_STAT_COUNTER") == 0)
-        {
-            groupPtr = &m_counterManager;
-        }
-        else if (strcmp(key.c_str(), "1S_STAT_STATUS") == 0)
-        {
-            groupPtr = &m_statusManager;
-        }
 
         if (op == SET_COMMAND)
         {
@@ -291,13 +182,31 @@ void FlexCounterOrch::initCounterTable()
     if (db_items_ptr != nullptr)
     {
         auto &db_items = *db_items_ptr;
+
+        /* Create the polling groups first, the id lists may refer to them */
+        for (auto &db_item : db_items)
+        {
+            string key = kfvKey(db_item);
+
+            if (key.compare(0, strlen(FLEX_COUNTER_GROUP_KEY_PREFIX), FLEX_COUNTER_GROUP_KEY_PREFIX) == 0 &&
+                kfvOp(db_item) == SET_COMMAND)
+            {
+                addCounterGroup(key.substr(strlen(FLEX_COUNTER_GROUP_KEY_PREFIX)), kfvFieldsValues(db_item));
+            }
+        }
+
         for (auto &db_item : db_items)
         {
             string key = kfvKey(db_item);
             string op = kfvOp(db_item);
+
+            if (key.compare(0, strlen(FLEX_COUNTER_GROUP_KEY_PREFIX), FLEX_COUNTER_GROUP_KEY_PREFIX) == 0)
+            {
+                continue;
+            }
    
-            unordered_map<string, unordered_set<string>&>::iterator itr;
-            if ((itr = g_flexCounterIds.find(key)) == g_flexCounterIds.end())
+            CounterType type;
+            if (!FlexCounterManager::findCounterType(key, type))
             {
                 SWSS_LOG_NOTICE("Invalid flex counter input, %s", key.c_str());
                 continue;
@@ -310,13 +219,201 @@ void FlexCounterOrch::initCounterTable()
                 for (auto i : kfvFieldsValues(db_item))
                 {
                     const auto& value = fvValue(i);
-                    itr->second.insert(value);
+                    if (fvField(i) == FLEX_COUNTER_GROUP_FIELD)
+                    {
+                        assignCounterGroup(type, value);
+                        continue;
+                    }
+                    FlexCounterManager::addCounterTypeStat(type, value);
                 }
             }
         }
     }
 
+    /* Serialize the stat lists once, they are shared by all objects of a type */
+    FlexCounterManager::serializeCounterTypeStats();
+
     m_flexCounterInit = true;
+
+    /* Release the object tasks waiting for the flex counter init */
+    OrchFSM::wakeup();
+}
+
+/*
+ * Called once the configuration has been replayed, the counters registered
+ * before a restart and not registered again are removed.
+ */
+void FlexCounterOrch::finishReconcile()
+{
+    SWSS_LOG_ENTER();
+
+    for (auto manager : m_managers)
+    {
+        manager->finishReconcile();
+    }
+}
+
+void FlexCounterOrch::flush()
+{
+    for (auto manager : m_managers)
+    {
+        manager->flush();
+    }
+}
+
+void FlexCounterOrch::getStats(vector<FieldValueTuple> &fvs)
+{
+    for (auto manager : m_managers)
+    {
+        uint64_t registered = manager->getRegisteredCount();
+        uint64_t ns = manager->getRegisterNs() + manager->getFlushNs();
+        uint64_t rate = ns ? registered * 1000000000 / ns : 0;
+
+        fvs.emplace_back(manager->getGroupName(),
+                         "interval-ms=" + to_string(manager->getPollingInterval()) +
+                         ",registered=" + to_string(registered) +
+                         ",cleared=" + to_string(manager->getClearedCount()) +
+                         ",flushes=" + to_string(manager->getFlushCount()) +
+                         ",register-us=" + to_string(manager->getRegisterNs() / 1000) +
+                         ",flush-us=" + to_string(manager->getFlushNs() / 1000) +
+                         ",per-sec=" + to_string(rate));
+    }
+}
+
+FlexCounterManager *FlexCounterOrch::findManager(const string &name)
+{
+    for (auto manager : m_managers)
+    {
+        if (manager->getGroupName() == name)
+        {
+            return manager;
+        }
+    }
+
+    return NULL;
+}
+
+FlexCounterManager *FlexCounterOrch::getManager(CounterType type)
+{
+    if (type >= CounterType::COUNTER_TYPE_MAX)
+    {
+        return NULL;
+    }
+
+    return m_counterTypeManagers[static_cast<size_t>(type)];
+}
+
+void FlexCounterOrch::addCounterGroup(const string &name, const vector<FieldValueTuple> &fvs)
+{
+    SWSS_LOG_ENTER();
+
+    StatsMode mode = StatsMode::STATS_MODE_GAUGE;
+    uint interval = DEFAULT_POLL_TIME;
+    bool mode_found = false;
+
+    for (auto &fv : fvs)
+    {
+        if (fvField(fv) == STATS_MODE_FIELD)
+        {
+            auto it = statsModeMap.find(fvValue(fv));
+            if (it == statsModeMap.end())
+            {
+                SWSS_LOG_ERROR("Invalid stats mode %s of flex counter group %s",
+                               fvValue(fv).c_str(), name.c_str());
+                return;
+            }
+            mode = it->second;
+            mode_found = true;
+        }
+        else if (fvField(fv) == POLL_INTERVAL_FIELD)
+        {
+            interval = static_cast<uint>(atoi(fvValue(fv).c_str()));
+        }
+    }
+
+    if (!mode_found || interval == 0)
+    {
+        SWSS_LOG_ERROR("Flex counter group %s needs a stats mode and a poll interval", name.c_str());
+        return;
+    }
+
+    auto manager = findManager(name);
+    if (manager != NULL)
+    {
+        if (manager->getStatsMode() != mode)
+        {
+            SWSS_LOG_ERROR("Flex counter group %s already exists with another stats mode", name.c_str());
+            return;
+        }
+        manager->updateGroupPollingInterval(interval);
+        return;
+    }
+
+    manager = new FlexCounterManager(name, mode, interval, true, gFlexCounterReconcile);
+    m_tierManagers[name] = unique_ptr<FlexCounterManager>(manager);
+    m_managers.push_back(manager);
+
+    SWSS_LOG_NOTICE("Added flex counter group %s, interval %u ms", name.c_str(), interval);
+}
+
+void FlexCounterOrch::assignCounterGroup(CounterType type, const string &name)
+{
+    SWSS_LOG_ENTER();
+
+    const CounterTypeInfo &info = FlexCounterManager::getCounterTypeInfo(type);
+    auto manager = findManager(name);
+
+    if (manager == NULL)
+    {
+        SWSS_LOG_ERROR("Failed to assign %s to flex counter group %s", info.json_key, name.c_str());
+        return;
+    }
+
+    if (manager->getStatsMode() != info.stats_mode)
+    {
+        SWSS_LOG_ERROR("Flex counter group %s doesn't match the stats mode of %s", name.c_str(), info.json_key);
+        return;
+    }
+
+    m_counterTypeManagers[static_cast<size_t>(type)] = manager;
+
+    SWSS_LOG_NOTICE("%s is polled by flex counter group %s", info.json_key, name.c_str());
+}
+
+void FlexCounterOrch::setCounterIdList(otai_object_id_t id, CounterType type)
+{
+    auto manager = getManager(type);
+    if (manager == NULL)
+    {
+        SWSS_LOG_ERROR("No flex counter group for counter type %d", static_cast<int>(type));
+        return;
+    }
+
+    manager->setCounterIdList(id, type);
+}
+
+void FlexCounterOrch::setCounterIdList(otai_object_id_t id, CounterType type,
+                                       const unordered_set<string> &counter_stats)
+{
+    auto manager = getManager(type);
+    if (manager == NULL)
+    {
+        SWSS_LOG_ERROR("No flex counter group for counter type %d", static_cast<int>(type));
+        return;
+    }
+
+    manager->setCounterIdList(id, type, counter_stats);
+}
+
+void FlexCounterOrch::clearCounterIdList(otai_object_id_t id)
+{
+    for (auto manager : m_managers)
+    {
+        if (manager->isInstalled(id))
+        {
+            manager->clearCounterIdList(id);
+        }
+    }
 }
 
 void FlexCounterOrch::doTask(Consumer& consumer)
@@ -1,6 +1,8 @@
 #ifndef FLEXCOUNTER_ORCH_H
 #define FLEXCOUNTER_ORCH_H
 
+#include <map>
+#include <memory>
 #include "orch.h"
 #include "producertable.h"
 #include "flex_counter_manager.h"
@@ -14,6 +16,15 @@ extern "C" {
 #define STAT_STATUS_COUNTER_FLEX_COUNTER_GROUP "1S_STAT_STATUS"
 #define DEFAULT_POLL_TIME 1000
 
+/*
+ * Extra polling groups are declared in the flexcounter json with a
+ * "FLEX_COUNTER_GROUP:<name>" key holding STATS_MODE and POLL_INTERVAL.
+ * A counter id list is moved to such a group by a FLEX_COUNTER_GROUP field,
+ * the other counter types stay in the 1S group of their stats mode.
+ */
+#define FLEX_COUNTER_GROUP_KEY_PREFIX "FLEX_COUNTER_GROUP:"
+#define FLEX_COUNTER_GROUP_FIELD "FLEX_COUNTER_GROUP"
+
 class FlexCounterOrch: public Orch
 {
 public:
@@ -27,8 +38,22 @@ public:
     FlexCounterManager *getGaugeGroup(){return &m_gaugeManager;};
     FlexCounterManager *getStatusGroup(){return &m_statusManager;};
     bool checkFlexCounterInit(){return m_flexCounterInit;};
+    void finishReconcile();
+    void flush();
+    void getStats(std::vector<swss::FieldValueTuple> &fvs);
+
+    /* Register or clear the counters of an object in the group of the counter type */
+    void setCounterIdList(otai_object_id_t id, CounterType type);
+    void setCounterIdList(otai_object_id_t id, CounterType type,
+                          const std::unordered_set<std::string> &counter_stats);
+    void clearCounterIdList(otai_object_id_t id);
  
 private:
+    FlexCounterManager *findManager(const std::string &name);
+    FlexCounterManager *getManager(CounterType type);
+    void addCounterGroup(const std::string &name, const std::vector<swss::FieldValueTuple> &fvs);
+    void assignCounterGroup(CounterType type, const std::string &name);
+
     std::shared_ptr<swss::DBConnector> m_flexCounterDb = nullptr;
     std::shared_ptr<swss::ProducerTable> m_flexCounterGroupTable = nullptr;
 private:
@@ -37,6 +62,13 @@ private:
     FlexCounterManager m_gaugeManager;
     FlexCounterManager m_counterManager;
     FlexCounterManager m_statusManager;
+
+    /* Polling groups declared in the flexcounter json */
+    std::map<std::string, std::unique_ptr<FlexCounterManager>> m_tierManagers;
+
+    /* All polling groups, the 1S groups first */
+    std::vector<FlexCounterManager *> m_managers;
+    std::array<FlexCounterManager *, COUNTER_TYPE_COUNT> m_counterTypeManagers;
 };
 
 #endif
@@ -22,8 +22,6 @@ using namespace std;
 using namespace swss;
 
 extern FlexCounterOrch* gFlexCounterOrch;
-extern std::unordered_set<std::string> interface_counter_ids_status;
-extern std::unordered_set<std::string> interface_counter_ids_counter;
 
 vector<otai_attr_id_t> g_interface_cfg_attrs =
 {
@@ -59,12 +57,11 @@ InterfaceOrch::InterfaceOrch(DBConnector *db, std::vector<TableConnector>& conne
 
 void InterfaceOrch::setFlexCounter(otai_object_id_t id, vector<otai_attribute_t> &attrs)
 {
-    gFlexCounterOrch->getStatusGroup()->setCounterIdList(id, CounterType::INTERFACE_STATUS, interface_counter_ids_status);
-    gFlexCounterOrch->getCounterGroup()->setCounterIdList(id, CounterType::INTERFACE_COUNTER, interface_counter_ids_counter);
+    gFlexCounterOrch->setCounterIdList(id, CounterType::INTERFACE_STATUS);
+    gFlexCounterOrch->setCounterIdList(id, CounterType::INTERFACE_COUNTER);
 }
 
 void InterfaceOrch::clearFlexCounter(otai_object_id_t id, string key)
 {
-    gFlexCounterOrch->getCounterGroup()->clearCounterIdList(id);
-    gFlexCounterOrch->getStatusGroup()->clearCounterIdList(id);
+    gFlexCounterOrch->clearCounterIdList(id);
 }
@@ -0,0 +1,313 @@
+/**
+ * Copyright (c) 2023 Alibaba Group Holding Limited
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABILITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ */
+
+#include <string.h>
+#include <sys/time.h>
+
+#include "latencytracer.h"
+#include "logger.h"
+
+using namespace std;
+using namespace swss;
+
+/*
+ * Values below 4 us have a bucket each, above the bucket is given by the
+ * most significant bit and the two bits below it.
+ */
+size_t LatencyHistogram::getBucket(uint64_t us)
+{
+    if (us < 4)
+    {
+        return static_cast<size_t>(us);
+    }
+
+    size_t msb = 63 - __builtin_clzll(us);
+    size_t sub = static_cast<size_t>((us >> (msb - 2)) & 3);
+    size_t bucket = 4 + (msb - 2) * 4 + sub;
+
+    return bucket < LATENCY_HISTOGRAM_BUCKETS ? bucket : LATENCY_HISTOGRAM_BUCKETS - 1;
+}
+
+uint64_t LatencyHistogram::getBucketUpperBound(size_t bucket)
+{
+    if (bucket < 4)
+    {
+        return bucket;
+    }
+
+    size_t shift = (bucket - 4) / 4;
+    uint64_t sub = (bucket - 4) % 4;
+
+    return ((4 + sub + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(uint64_t us)
+{
+    m_buckets[getBucket(us)].fetch_add(1, memory_order_relaxed);
+    m_count.fetch_add(1, memory_order_relaxed);
+    m_sum.fetch_add(us, memory_order_relaxed);
+
+    uint64_t max = m_max.load(memory_order_relaxed);
+    while (us > max && !m_max.compare_exchange_weak(max, us, memory_order_relaxed))
+    {
+    }
+}
+
+/* Upper bound of the bucket holding the percentile, capped by the max */
+uint64_t LatencyHistogram::getPercentile(double percentile) const
+{
+    uint64_t count = getCount();
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    uint64_t rank = static_cast<uint64_t>(percentile / 100 * static_cast<double>(count));
+    uint64_t seen = 0;
+
+    for (size_t i = 0; i < LATENCY_HISTOGRAM_BUCKETS; i++)
+    {
+        seen += m_buckets[i].load(memory_order_relaxed);
+        if (seen > rank)
+        {
+            return min(getBucketUpperBound(i), getMax());
+        }
+    }
+
+    return getMax();
+}
+
+string LatencyHistogram::toString() const
+{
+    uint64_t count = getCount();
+    uint64_t avg = count ? m_sum.load(memory_order_relaxed) / count : 0;
+
+    return "count=" + to_string(count) +
+           ",avg-us=" + to_string(avg) +
+           ",p50-us=" + to_string(getPercentile(50)) +
+           ",p90-us=" + to_string(getPercentile(90)) +
+           ",p99-us=" + to_string(getPercentile(99)) +
+           ",max-us=" + to_string(getMax());
+}
+
+LatencyTracer &LatencyTracer::getInstance()
+{
+    static LatencyTracer tracer;
+
+    return tracer;
+}
+
+/* Wall clock, the receive stage is stamped by configsyncd */
+uint64_t LatencyTracer::now()
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+
+    return static_cast<uint64_t>(tv.tv_sec) * 1000000 + static_cast<uint64_t>(tv.tv_usec);
+}
+
+void LatencyTracer::begin(const string &operation_id, const string &table, uint64_t receive_us)
+{
+    auto it = m_inflight.find(operation_id);
+    if (it != m_inflight.end())
+    {
+        erase(it);
+    }
+    else if (m_inflight.size() >= LATENCY_MAX_INFLIGHT)
+    {
+        /* Operations without a result are never finished, drop the oldest */
+        erase(m_inflight.find(m_order.front()));
+        m_dropped++;
+    }
+
+    Trace &trace = m_inflight[operation_id];
+
+    trace.table = table;
+    trace.stamps[LATENCY_STAGE_RECEIVE] = receive_us;
+    trace.stamps[LATENCY_STAGE_POP] = now();
+    trace.order = m_order.insert(m_order.end(), operation_id);
+}
+
+void LatencyTracer::erase(unordered_map<string, Trace>::iterator it)
+{
+    m_order.erase(it->second.order);
+    m_inflight.erase(it);
+}
+
+/* The OTAI start is the first call of the operation, the end the last one */
+void LatencyTracer::mark(const string &operation_id, LatencyStage stage)
+{
+    auto it = m_inflight.find(operation_id);
+    if (it == m_inflight.end())
+    {
+        return;
+    }
+
+    if (stage == LATENCY_STAGE_OTAI_START && it->second.stamps[stage] != 0)
+    {
+        return;
+    }
+
+    it->second.stamps[stage] = now();
+}
+
+void LatencyTracer::finish(const string &operation_id)
+{
+    auto it = m_inflight.find(operation_id);
+    if (it == m_inflight.end())
+    {
+        return;
+    }
+
+    Trace &trace = it->second;
+    uint64_t *stamps = trace.stamps;
+
+    stamps[LATENCY_STAGE_PUBLISH] = now();
+
+    auto &histograms = m_histograms[trace.table];
+    if (!histograms)
+    {
+        histograms.reset(new TableHistograms());
+    }
+
+    /* The wall clock may step, a negative segment is not recorded */
+    auto segment = [](uint64_t from, uint64_t to, LatencyHistogram &histogram)
+    {
+        if (from != 0 && to >= from)
+        {
+            histogram.record(to - from);
+        }
+    };
+
+    uint64_t first = stamps[LATENCY_STAGE_RECEIVE] ? stamps[LATENCY_STAGE_RECEIVE] : stamps[LATENCY_STAGE_POP];
+    uint64_t last_otai = stamps[LATENCY_STAGE_OTAI_END] ? stamps[LATENCY_STAGE_OTAI_END] : stamps[LATENCY_STAGE_POP];
+
+    segment(stamps[LATENCY_STAGE_RECEIVE], stamps[LATENCY_STAGE_POP], histograms->queue);
+    if (stamps[LATENCY_STAGE_OTAI_START] != 0)
+    {
+        segment(stamps[LATENCY_STAGE_POP], stamps[LATENCY_STAGE_OTAI_START], histograms->wait);
+        segment(stamps[LATENCY_STAGE_OTAI_START], stamps[LATENCY_STAGE_OTAI_END], histograms->otai);
+    }
+    segment(last_otai, stamps[LATENCY_STAGE_PUBLISH], histograms->publish);
+    segment(first, stamps[LATENCY_STAGE_PUBLISH], histograms->total);
+
+    append(operation_id, trace);
+
+    erase(it);
+}
+
+/* The operation is handled without a result queued on its operation-id */
+void LatencyTracer::abandon(const string &operation_id)
+{
+    auto it = m_inflight.find(operation_id);
+    if (it == m_inflight.end() || it->second.stamps[LATENCY_STAGE_PUBLISH] != 0)
+    {
+        return;
+    }
+
+    erase(it);
+    m_abandoned++;
+}
+
+/*
+ * The sequence of a slot is odd while it is written and even once the record
+ * is complete, a reader copies the record and checks the sequence is the
+ * same before and after the copy.
+ */
+void LatencyTracer::append(const string &operation_id, const Trace &trace)
+{
+    uint64_t index = m_head.fetch_add(1, memory_order_relaxed);
+    Record &record = m_ring[index & (LATENCY_RING_SIZE - 1)];
+
+    record.sequence.store(index * 2 + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    strncpy(record.operationId, operation_id.c_str(), sizeof(record.operationId) - 1);
+    record.operationId[sizeof(record.operationId) - 1] = '\0';
+    strncpy(record.table, trace.table.c_str(), sizeof(record.table) - 1);
+    record.table[sizeof(record.table) - 1] = '\0';
+    memcpy(record.stamps, trace.stamps, sizeof(record.stamps));
+
+    record.sequence.store(index * 2 + 2, memory_order_release);
+}
+
+void LatencyTracer::getStats(vector<FieldValueTuple> &fvs) const
+{
+    for (auto &it : m_histograms)
+    {
+        fvs.emplace_back(it.first + "|queue", it.second->queue.toString());
+        fvs.emplace_back(it.first + "|wait", it.second->wait.toString());
+        fvs.emplace_back(it.first + "|otai", it.second->otai.toString());
+        fvs.emplace_back(it.first + "|publish", it.second->publish.toString());
+        fvs.emplace_back(it.first + "|total", it.second->total.toString());
+    }
+
+    fvs.emplace_back("inflight", "count=" + to_string(m_inflight.size()) +
+                                 ",dropped=" + to_string(m_dropped) +
+                                 ",abandoned=" + to_string(m_abandoned) +
+                                 ",completed=" + to_string(m_head.load(memory_order_relaxed)));
+}
+
+/* Completed operations of the ring which took threshold_ms or more, oldest first */
+void LatencyTracer::getSlowRecords(uint64_t threshold_ms, vector<FieldValueTuple> &fvs) const
+{
+    uint64_t head = m_head.load(memory_order_acquire);
+    uint64_t start = head > LATENCY_RING_SIZE ? head - LATENCY_RING_SIZE : 0;
+
+    for (uint64_t index = start; index < head; index++)
+    {
+        const Record &record = m_ring[index & (LATENCY_RING_SIZE - 1)];
+
+        uint64_t sequence = record.sequence.load(memory_order_acquire);
+        if (sequence != index * 2 + 2)
+        {
+            continue;
+        }
+
+        char operation_id[sizeof(record.operationId)];
+        char table[sizeof(record.table)];
+        uint64_t stamps[LATENCY_STAGE_MAX];
+
+        memcpy(operation_id, record.operationId, sizeof(operation_id));
+        memcpy(table, record.table, sizeof(table));
+        memcpy(stamps, record.stamps, sizeof(stamps));
+
+        atomic_thread_fence(memory_order_acquire);
+        if (record.sequence.load(memory_order_relaxed) != sequence)
+        {
+            continue;
+        }
+
+        uint64_t first = stamps[LATENCY_STAGE_RECEIVE] ? stamps[LATENCY_STAGE_RECEIVE] : stamps[LATENCY_STAGE_POP];
+        if (stamps[LATENCY_STAGE_PUBLISH] < first ||
+            stamps[LATENCY_STAGE_PUBLISH] - first < threshold_ms * 1000)
+        {
+            continue;
+        }
+
+        /* Stages as offsets from the first one, 0 when the stage was not seen */
+        string value = string("table=") + table;
+        const char *names[LATENCY_STAGE_MAX] = { "receive", "pop", "otai-start", "otai-end", "publish" };
+        for (size_t i = 0; i < LATENCY_STAGE_MAX; i++)
+        {
+            uint64_t offset = stamps[i] >= first ? stamps[i] - first : 0;
+            value += string(",") + names[i] + "-us=" + to_string(stamps[i] ? offset : 0);
+        }
+
+        fvs.emplace_back(operation_id, value);
+    }
+}
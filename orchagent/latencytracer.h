@@ -0,0 +1,136 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "table.h"
+
+/* Size of the ring of the last completed operations, a power of two */
+#define LATENCY_RING_SIZE 1024
+
+/* Operations traced at the same time, the oldest ones are dropped beyond */
+#define LATENCY_MAX_INFLIGHT 4096
+
+#define LATENCY_DEFAULT_SLOW_MS 100
+
+#define LATENCY_HISTOGRAM_BUCKETS 128
+
+enum LatencyStage
+{
+    LATENCY_STAGE_RECEIVE,
+    LATENCY_STAGE_POP,
+    LATENCY_STAGE_OTAI_START,
+    LATENCY_STAGE_OTAI_END,
+    LATENCY_STAGE_PUBLISH,
+    LATENCY_STAGE_MAX,
+};
+
+// LatencyHistogram counts latencies in microseconds in log2 buckets split in
+// four sub-buckets, so a bucket is at most 25% wide whatever the magnitude,
+// like a HDR histogram with two significant bits. The counters are atomics,
+// a reader never blocks the recording thread.
+class LatencyHistogram
+{
+public:
+    void record(uint64_t us);
+
+    uint64_t getCount() const { return m_count.load(std::memory_order_relaxed); }
+    uint64_t getMax() const { return m_max.load(std::memory_order_relaxed); }
+    uint64_t getPercentile(double percentile) const;
+
+    std::string toString() const;
+
+private:
+    static size_t getBucket(uint64_t us);
+    static uint64_t getBucketUpperBound(size_t bucket);
+
+    std::atomic<uint64_t> m_buckets[LATENCY_HISTOGRAM_BUCKETS] = {};
+    std::atomic<uint64_t> m_count = { 0 };
+    std::atomic<uint64_t> m_sum = { 0 };
+    std::atomic<uint64_t> m_max = { 0 };
+};
+
+// LatencyTracer follows the northbound writes carrying an operation-id from
+// configsyncd to the published result. The stages are stamped with the
+// wall clock in microseconds, configsyncd stamps the receive time in the
+// "operation-ts" field of the APPL_DB entry. Consumer::execute() strips the
+// field from the task and deletes it from APPL_DB once the task is handled.
+//
+// The publish stage is stamped when the result is sent by ResultPublisher::
+// flush(). An operation handled without a result queued on its operation-id is
+// abandoned, and at most LATENCY_MAX_INFLIGHT operations are traced at the
+// same time, beyond the oldest one is dropped.
+//
+// Completed operations are appended to a ring of LATENCY_RING_SIZE records.
+// The writer claims a slot with an atomic index and publishes it with a
+// per-slot sequence number, so the ring is read without a lock and a record
+// overwritten while being read is skipped. Per-table histograms of each
+// segment between two stages tell whether an operation waited in Redis,
+// in the orchagent queues or in the OTAI driver.
+class LatencyTracer
+{
+public:
+    static LatencyTracer &getInstance();
+
+    static uint64_t now();
+
+    void begin(const std::string &operation_id, const std::string &table, uint64_t receive_us);
+
+    void mark(const std::string &operation_id, LatencyStage stage);
+
+    void finish(const std::string &operation_id);
+
+    void abandon(const std::string &operation_id);
+
+    void getStats(std::vector<swss::FieldValueTuple> &fvs) const;
+
+    void getSlowRecords(uint64_t threshold_ms, std::vector<swss::FieldValueTuple> &fvs) const;
+
+private:
+    LatencyTracer() = default;
+
+    struct Trace
+    {
+        std::string table;
+        uint64_t stamps[LATENCY_STAGE_MAX] = {};
+        std::list<std::string>::iterator order;
+    };
+
+    struct Record
+    {
+        std::atomic<uint64_t> sequence = { 0 };
+        char operationId[64];
+        char table[48];
+        uint64_t stamps[LATENCY_STAGE_MAX];
+    };
+
+    struct TableHistograms
+    {
+        LatencyHistogram queue;
+        LatencyHistogram wait;
+        LatencyHistogram otai;
+        LatencyHistogram publish;
+        LatencyHistogram total;
+    };
+
+    void append(const std::string &operation_id, const Trace &trace);
+
+    void erase(std::unordered_map<std::string, Trace>::iterator it);
+
+    std::unordered_map<std::string, Trace> m_inflight;
+    /* The operation-ids of m_inflight in the order they began, oldest first */
+    std::list<std::string> m_order;
+    uint64_t m_dropped = 0;
+    uint64_t m_abandoned = 0;
+
+    std::map<std::string, std::unique_ptr<TableHistograms>> m_histograms;
+
+    std::atomic<uint64_t> m_head = { 0 };
+    Record m_ring[LATENCY_RING_SIZE];
+};
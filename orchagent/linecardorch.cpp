@@ -29,6 +29,7 @@
 #include "notificationproducer.h"
 #include "notifications.h"
 #include "orchfsm.h"
+#include "event.h"
 #include "subscriberstatetable.h"
 #include "otaihelper.h"
 #include "timestamp.h"
@@ -38,10 +39,8 @@ using namespace std;
 using namespace swss;
 
 extern FlexCounterOrch *gFlexCounterOrch;
-extern std::unordered_set<std::string> linecard_counter_ids_status;
-extern std::unordered_set<std::string> linecard_counter_ids_gauge;
-extern std::unordered_set<std::string> linecard_counter_ids_counter;
 extern int gSlotId;
+extern bool gWarmStart;
 extern FlexCounterOrch* gFlexCounterOrch;
 
 vector<otai_attr_id_t> g_linecard_cfg_attrs =
@@ -68,6 +67,12 @@ vector<otai_attr_id_t> g_linecard_cfg_attrs =
     OTAI_LINECARD_ATTR_LED_FLASH_INTERVAL,
 };
 
+#define BOARD_MODE_POLL_INTERVAL_SEC 1
+/* 10 minutes is enough for P230C to change its boardmode */
+#define BOARD_MODE_WAIT_TIMEOUT_SEC  (10 * 60)
+/* Retry dependency of the linecard tasks received during a board-mode change */
+#define BOARD_MODE_DEPENDENCY "board-mode"
+
 vector<otai_attr_id_t> g_linecard_state_attrs = 
 {
     OTAI_LINECARD_ATTR_UPGRADE_STATE,
@@ -105,19 +110,15 @@ LinecardOrch::LinecardOrch(DBConnector *db, std::vector<TableConnector>& connect
     m_setFunc = otai_linecard_api->set_linecard_attribute;
     m_getFunc = otai_linecard_api->get_linecard_attribute;
 
-    for (auto i : g_linecard_state_attrs)
-    {
-        auto meta = otai_metadata_get_attr_metadata(OTAI_OBJECT_TYPE_LINECARD, i);
-        if (meta == NULL)
-        {   
-            SWSS_LOG_ERROR("invalid attr, object=LINECARD, attr=%d", i);
-            continue;
-        }
-        if (meta->isreadonly == true)
-        {
-            m_readonlyAttrs[meta->attridkebabname] = i;
-        }
-    }
+    addAttrDescs(g_linecard_state_attrs);
+
+    auto interval = timespec { .tv_sec = BOARD_MODE_POLL_INTERVAL_SEC, .tv_nsec = 0 };
+    m_boardModeTimer = new SelectableTimer(interval);
+    auto executor = new ExecutableTimer(m_boardModeTimer, this, "BOARD_MODE_POLL");
+    Orch::addExecutor(executor);
+
+    /* Nothing to do on wakeup, the event loop drains the dirty orchs after it */
+    Orch::addExecutor(new ExecutableEvent(OrchFSM::createWakeupEvent(), this, "ORCH_FSM_WAKEUP"));
 }
 
 void LinecardOrch::initConfigTotalNum(int num)
@@ -168,15 +169,84 @@ void LinecardOrch::stopPreConfigProc()
 
     SWSS_LOG_NOTICE("Pre-Config Finished.");
 
-    attr.id = OTAI_LINECARD_ATTR_STOP_PRE_CONFIGURATION;
-    attr.value.booldata = true;
-    status = otai_linecard_api->set_linecard_attribute(gLinecardId, &attr);
-    if (status != OTAI_STATUS_SUCCESS)
+    if (gWarmStart)
     {
-        SWSS_LOG_ERROR("Failed to notify Otai pre-config finish %d", status);
+        /* No pre-config was started, see createLinecard() */
+        m_warmTotalAvoidedCalls++;
+    }
+    else
+    {
+        attr.id = OTAI_LINECARD_ATTR_STOP_PRE_CONFIGURATION;
+        attr.value.booldata = true;
+        status = otai_linecard_api->set_linecard_attribute(gLinecardId, &attr);
+        if (status != OTAI_STATUS_SUCCESS)
+        {
+            SWSS_LOG_ERROR("Failed to notify Otai pre-config finish %d", status);
+        }
+    }
+
+    gFlexCounterOrch->finishReconcile();
+
+    if (gWarmStart && !m_warmRestartDone)
+    {
+        m_warmRestartDone = true;
+        m_warmRestartMs = (long)chrono::duration_cast<chrono::milliseconds>(
+            chrono::steady_clock::now() - m_warmRestartStart).count();
+
+        SWSS_LOG_NOTICE("Warm restart finished in %ld ms, %" PRIu64 " OTAI calls avoided",
+                        m_warmRestartMs, m_warmTotalAvoidedCalls);
     }
 }
 
+void LinecardOrch::setOrchList(const vector<Orch *> &orch_list)
+{
+    m_orchList = orch_list;
+}
+
+void LinecardOrch::fallBackToColdStart()
+{
+    SWSS_LOG_ENTER();
+
+    for (auto o : m_orchList)
+    {
+        auto object_orch = dynamic_cast<OtaiObjectOrch *>(o);
+        if (object_orch == NULL || object_orch == this)
+        {
+            continue;
+        }
+
+        object_orch->abortWarmStart();
+    }
+
+    OtaiObjectOrch::abortWarmStart();
+
+    gWarmStart = false;
+    m_warmStartAborted = true;
+}
+
+bool LinecardOrch::bake()
+{
+    SWSS_LOG_ENTER();
+
+    m_warmRestartStart = chrono::steady_clock::now();
+
+    return OtaiObjectOrch::bake();
+}
+
+void LinecardOrch::getWarmRestartSummary(vector<FieldValueTuple> &fvs) const
+{
+    if (!gWarmStart && !m_warmStartAborted)
+    {
+        return;
+    }
+
+    fvs.emplace_back("warm-start",
+                     string("done=") + (m_warmRestartDone ? "true" : "false") +
+                     ",aborted=" + (m_warmStartAborted ? "true" : "false") +
+                     ",restart-ms=" + to_string(m_warmRestartMs) +
+                     ",calls-avoided=" + to_string(m_warmTotalAvoidedCalls));
+}
+
 void LinecardOrch::doAppLinecardTableTask(Consumer& consumer)
 {
     SWSS_LOG_ENTER();
@@ -193,6 +263,13 @@ void LinecardOrch::doAppLinecardTableTask(Consumer& consumer)
         auto op = kfvOp(t);
         string key = kfvKey(t);
 
+        if (m_boardModePhase != BOARD_MODE_IDLE)
+        {
+            /* Handle the task once the linecard creation is finished */
+            it = consumer.retryLater(it, "board-mode change in progress", BOARD_MODE_DEPENDENCY);
+            continue;
+        }
+
         if (op == SET_COMMAND)
         {
             string operation_id;
@@ -202,6 +279,8 @@ void LinecardOrch::doAppLinecardTableTask(Consumer& consumer)
 
             for (auto i : kfvFieldsValues(t))
             {
+                auto desc = getAttrDesc(fvField(i));
+
                 if (fvField(i) == "operation-id")
                 {
                     operation_id = fvValue(i);
@@ -214,11 +293,11 @@ void LinecardOrch::doAppLinecardTableTask(Consumer& consumer)
                 {
                     create_attrs[fvField(i)] = fvValue(i);
                 }
-                else if (m_createandsetAttrs.find(fvField(i)) != m_createandsetAttrs.end())
+                else if (desc != NULL && desc->createandset)
                 {
                     set_attrs[fvField(i)] = fvValue(i);
                 }
-                if (m_mandatoryAttrs.find(fvField(i)) != m_mandatoryAttrs.end())
+                if (desc != NULL && desc->mandatory)
                 {
                     create_attrs[fvField(i)] = fvValue(i);
                 }
@@ -227,7 +306,13 @@ void LinecardOrch::doAppLinecardTableTask(Consumer& consumer)
             {
                 createLinecard(key, create_attrs);
             }
-            if (OrchFSM::getState() == ORCH_STATE_WORK)
+            if (m_boardModePhase != BOARD_MODE_IDLE)
+            {
+                /* Applied once the linecard creation is finished */
+                m_pendingLinecardAttrs = set_attrs;
+                m_pendingOperationId = operation_id;
+            }
+            else if (OrchFSM::getState() == ORCH_STATE_WORK)
             {
                 setOtaiObjectAttrs(key, set_attrs, operation_id);
             }
@@ -350,21 +435,56 @@ void LinecardOrch::createLinecard(
     }
     SWSS_LOG_NOTICE("Create a linecard, id:%" PRIu64, gLinecardId);
 
-    m_key2oid[key] = gLinecardId;
+    /*
+     * On warm start the objects of the previous run are kept, they are only
+     * valid if the linecard is attached with the same oid. Otherwise every
+     * orch drops its restored objects and the start goes on as a cold one.
+     */
+    OtaiObjectRecord *object = getObject(key);
+    if (object != NULL && object->restored && object->oid != gLinecardId)
+    {
+        SWSS_LOG_ERROR("Linecard oid changed from %" PRIx64 " to %" PRIx64 " on warm start, "
+                       "falling back to a cold start", object->oid, gLinecardId);
+        fallBackToColdStart();
+    }
+    else if (object != NULL && object->restored)
+    {
+        object->restored = false;
+        m_reconcilePendingCount--;
+        m_reconciledCount++;
+    }
+
+    setObjectId(key, gLinecardId);
 
-    attr.id = OTAI_LINECARD_ATTR_START_PRE_CONFIGURATION;
-    attr.value.booldata = true;
-    status = otai_linecard_api->set_linecard_attribute(gLinecardId, &attr);
-    if (status != OTAI_STATUS_SUCCESS)
+    if (gWarmStart)
+    {
+        /* The kept objects don't need a pre-config, see stopPreConfigProc() */
+        m_warmTotalAvoidedCalls++;
+    }
+    else
     {
-        SWSS_LOG_ERROR("Failed to notify Otai start pre-config %d", status);
+        attr.id = OTAI_LINECARD_ATTR_START_PRE_CONFIGURATION;
+        attr.value.booldata = true;
+        status = otai_linecard_api->set_linecard_attribute(gLinecardId, &attr);
+        if (status != OTAI_STATUS_SUCCESS)
+        {
+            SWSS_LOG_ERROR("Failed to notify Otai start pre-config %d", status);
+        }
     }
 
-    if (is_board_mode_existed)
+    if (is_board_mode_existed && startBoardModeChange(board_mode))
     {
-        setBoardMode(board_mode);
+        m_pendingLinecardKey = key;
+        return;
     }
 
+    finishCreateLinecard(key);
+}
+
+void LinecardOrch::finishCreateLinecard(const string &key)
+{
+    SWSS_LOG_ENTER();
+
     FieldValueTuple tuple(otai_serialize_object_id(gLinecardId), key);
     vector<FieldValueTuple> fields;
     fields.push_back(tuple);
@@ -377,11 +497,14 @@ void LinecardOrch::createLinecard(
     OrchFSM::setState(ORCH_STATE_WORK);
 }
 
-void LinecardOrch::setBoardMode(std::string mode)
+/*
+ * Start a board-mode change and return true if the creation of the linecard
+ * has to wait for it. The new mode is polled by doTask(SelectableTimer&).
+ */
+bool LinecardOrch::startBoardModeChange(const std::string &mode)
 {
     SWSS_LOG_ENTER();
 
-    int wait_count = 0;
     otai_attribute_t attr;
     otai_status_t status;
 
@@ -391,11 +514,13 @@ void LinecardOrch::setBoardMode(std::string mode)
     if (status == OTAI_STATUS_SUCCESS && mode == attr.value.chardata)
     {
         SWSS_LOG_DEBUG("Linecard and maincard have a same board-mode, %s", mode.c_str());
-        return;
+        return false;
     }
 
     SWSS_LOG_NOTICE("Begin to set board-mode %s", mode.c_str());
 
+    m_boardModeSetStart = chrono::steady_clock::now();
+
     memset(attr.value.chardata, 0, sizeof(attr.value.chardata));
     strncpy(attr.value.chardata, mode.c_str(), sizeof(attr.value.chardata) - 1);
     status = otai_linecard_api->set_linecard_attribute(gLinecardId, &attr);
@@ -403,32 +528,84 @@ void LinecardOrch::setBoardMode(std::string mode)
     {
         SWSS_LOG_ERROR("Failed to set board-mode status=%d, mode=%s",
                        status, mode.c_str());
+        return false;
+    }
+
+    m_boardModeWaitStart = chrono::steady_clock::now();
+    m_boardMode = mode;
+    m_boardModePhase = BOARD_MODE_WAITING;
+    m_boardModeTimer->start();
+
+    return true;
+}
+
+void LinecardOrch::doTask(SelectableTimer &timer)
+{
+    SWSS_LOG_ENTER();
+
+    if (&timer != m_boardModeTimer)
+    {
+        OtaiObjectOrch::doTask(timer);
         return;
     }
 
-    do
+    if (m_boardModePhase != BOARD_MODE_WAITING)
+    {
+        return;
+    }
+
+    otai_attribute_t attr;
+    otai_status_t status;
+    bool done = false;
+
+    attr.id = OTAI_LINECARD_ATTR_BOARD_MODE;
+    memset(attr.value.chardata, 0, sizeof(attr.value.chardata));
+    status = otai_linecard_api->get_linecard_attribute(gLinecardId, 1, &attr);
+    if (status == OTAI_STATUS_SUCCESS)
     {
-        wait_count++;
-        this_thread::sleep_for(chrono::milliseconds(1000));
-        status = otai_linecard_api->get_linecard_attribute(gLinecardId, 1, &attr);
-        if (status != OTAI_STATUS_SUCCESS)
-        {
-            continue;
-        }
         SWSS_LOG_DEBUG("board-mode = %s", attr.value.chardata);
-        if (mode == attr.value.chardata)
-        {
-            break;
-        }
-    } while (wait_count < 10 * 60); /* 10 minutes is enough for P230C to change its boardmode */
+        done = (m_boardMode == attr.value.chardata);
+    }
+
+    auto now = chrono::steady_clock::now();
+    auto wait_sec = chrono::duration_cast<chrono::seconds>(now - m_boardModeWaitStart).count();
+
+    if (!done && wait_sec < BOARD_MODE_WAIT_TIMEOUT_SEC)
+    {
+        return;
+    }
+
+    m_boardModeTimer->stop();
+    m_boardModePhase = BOARD_MODE_IDLE;
+
+    if (!done)
+    {
+        SWSS_LOG_ERROR("Timeout waiting for board-mode %s", m_boardMode.c_str());
+    }
+
+    auto set_ms = chrono::duration_cast<chrono::milliseconds>(m_boardModeWaitStart - m_boardModeSetStart).count();
+    auto wait_ms = chrono::duration_cast<chrono::milliseconds>(now - m_boardModeWaitStart).count();
+
+    finishCreateLinecard(m_pendingLinecardKey);
+
+    setOtaiObjectAttrs(m_pendingLinecardKey, m_pendingLinecardAttrs, m_pendingOperationId);
+
+    auto finish_ms = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - now).count();
+
+    SWSS_LOG_NOTICE("The end of setting board-mode %s, set %ld ms, wait %ld ms, finish %ld ms",
+                    m_boardMode.c_str(), (long)set_ms, (long)wait_ms, (long)finish_ms);
+
+    m_pendingLinecardKey.clear();
+    m_pendingLinecardAttrs.clear();
+    m_pendingOperationId.clear();
 
-    SWSS_LOG_NOTICE("The end of setting board-mode");
+    releaseRetries(BOARD_MODE_DEPENDENCY);
 }
 
 void LinecardOrch::setFlexCounter(otai_object_id_t id)
 {
-    gFlexCounterOrch->getGaugeGroup()->setCounterIdList(id, CounterType::LINECARD_GAUGE, linecard_counter_ids_gauge);
-    gFlexCounterOrch->getCounterGroup()->setCounterIdList(id, CounterType::LINECARD_COUNTER, linecard_counter_ids_counter);
-    gFlexCounterOrch->getStatusGroup()->setCounterIdList(id, CounterType::LINECARD_STATUS, linecard_counter_ids_status);
+    gFlexCounterOrch->setCounterIdList(id, CounterType::LINECARD_GAUGE);
+    gFlexCounterOrch->setCounterIdList(id, CounterType::LINECARD_COUNTER);
+    gFlexCounterOrch->setCounterIdList(id, CounterType::LINECARD_STATUS);
 }
 
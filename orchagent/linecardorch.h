@@ -1,11 +1,18 @@
 #pragma once
 
+#include <chrono>
 #include "orch.h"
 #include "timer.h"
 #include "dbconnector.h"
 #include "otaiobjectorch.h"
 #include "orchfsm.h"
 
+typedef enum _BoardModePhase_E
+{
+    BOARD_MODE_IDLE = 0,
+    BOARD_MODE_WAITING,
+} BoardModePhase_E;
+
 struct WarmRestartCheck
 {
     bool checkRestartReadyState;
@@ -25,18 +32,53 @@ public:
     void initConfigTotalNum(int num);
     void incConfigNum();
     void stopPreConfigProc();
+    bool bake() override;
+    void setOrchList(const std::vector<Orch *> &orch_list);
+    void fallBackToColdStart();
+    void addWarmAvoidedCalls(uint64_t calls) { m_warmTotalAvoidedCalls += calls; }
+    void getWarmRestartSummary(std::vector<swss::FieldValueTuple> &fvs) const;
 
 private:
     void doTask(Consumer& consumer);
     void doAppLinecardTableTask(Consumer& consumer);
     void doLinecardStateTask(Consumer& consumer);
+    void doTask(swss::SelectableTimer &timer);
     void setFlexCounter(otai_object_id_t id);
-    void setBoardMode(std::string mode);
+    bool startBoardModeChange(const std::string &mode);
+    void finishCreateLinecard(const std::string &key);
 
     swss::DBConnector* m_db;
     WarmRestartCheck m_warmRestartCheck = { false, false, false };
     int m_config_total_num;
     bool m_config_total_num_inited;
     int m_config_num;
+
+    /*
+     * A board-mode change may take minutes. It is polled by m_boardModeTimer
+     * so the event loop keeps running, and the linecard creation is finished
+     * once the new mode is reported or the wait times out. The attributes
+     * and operation-id of the entry which created the linecard are set then.
+     */
+    BoardModePhase_E m_boardModePhase = BOARD_MODE_IDLE;
+    std::string m_boardMode;
+    std::string m_pendingLinecardKey;
+    std::map<std::string, std::string> m_pendingLinecardAttrs;
+    std::string m_pendingOperationId;
+    swss::SelectableTimer *m_boardModeTimer;
+    std::chrono::steady_clock::time_point m_boardModeSetStart;
+    std::chrono::steady_clock::time_point m_boardModeWaitStart;
+
+    /*
+     * Warm start, from bake() to the end of the pre-config. The OTAI calls
+     * avoided by each orch are added once its objects are reconciled. The
+     * warm start of all the orchs of m_orchList is aborted if the linecard
+     * is not attached with its previous oid.
+     */
+    bool m_warmRestartDone = false;
+    bool m_warmStartAborted = false;
+    std::vector<Orch *> m_orchList;
+    std::chrono::steady_clock::time_point m_warmRestartStart;
+    long m_warmRestartMs = 0;
+    uint64_t m_warmTotalAvoidedCalls = 0;
 };
 
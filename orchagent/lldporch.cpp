@@ -23,7 +23,6 @@ using namespace swss;
 
 extern FlexCounterOrch *gFlexCounterOrch;
 
-extern std::unordered_set<std::string> lldp_counter_ids_status;
 
 vector<otai_attr_id_t> g_lldp_cfg_attrs =
 {
@@ -56,6 +55,6 @@ LldpOrch::LldpOrch(DBConnector *db, const vector<string> &table_names)
 
 void LldpOrch::setFlexCounter(otai_object_id_t id, vector<otai_attribute_t> &attrs)
 {            
-    gFlexCounterOrch->getStatusGroup()->setCounterIdList(id, CounterType::LLDP_STATUS, lldp_counter_ids_status);
+    gFlexCounterOrch->setCounterIdList(id, CounterType::LLDP_STATUS);
 }
 
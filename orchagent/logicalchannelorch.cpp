@@ -21,8 +21,6 @@
 using namespace std;
 
 extern FlexCounterOrch *gFlexCounterOrch;
-extern std::unordered_set<std::string> logicalch_counter_ids_status;
-extern std::unordered_set<std::string> logicalch_counter_ids_counter;
 
 vector<otai_attr_id_t> g_logicalchannel_cfg_attrs =
 {
@@ -66,13 +64,12 @@ LogicalChannelOrch::LogicalChannelOrch(DBConnector *db, std::vector<TableConnect
 
 void LogicalChannelOrch::setFlexCounter(otai_object_id_t id, vector<otai_attribute_t> &attrs)
 {    
-    gFlexCounterOrch->getCounterGroup()->setCounterIdList(id, CounterType::LOGICALCH_COUNTER, logicalch_counter_ids_counter);        
-    gFlexCounterOrch->getStatusGroup()->setCounterIdList(id, CounterType::LOGICALCH_STATUS, logicalch_counter_ids_status);
+    gFlexCounterOrch->setCounterIdList(id, CounterType::LOGICALCH_COUNTER);        
+    gFlexCounterOrch->setCounterIdList(id, CounterType::LOGICALCH_STATUS);
 }
 
 void LogicalChannelOrch::clearFlexCounter(otai_object_id_t id, string key)
 {
-    gFlexCounterOrch->getCounterGroup()->clearCounterIdList(id);
-    gFlexCounterOrch->getStatusGroup()->clearCounterIdList(id);
+    gFlexCounterOrch->clearCounterIdList(id);
 }
 
@@ -24,6 +24,8 @@ extern "C" {
 #include "orchdaemon.h"
 #include "otai_serialize.h"
 #include "otaihelper.h"
+#include "dbconnectorpool.h"
+#include "otaiapistats.h"
 #include <signal.h>
 
 using namespace std;
@@ -38,14 +40,25 @@ otai_object_id_t gLinecardId = OTAI_NULL_OBJECT_ID;
 int gBatchSize = DEFAULT_BATCH_SIZE;
 int gSlotId = 0;
 string gFlexcounterJsonFile;
+bool gResultSummaryMode = false;
+bool gFlexCounterReconcile = false;
+bool gWarmStart = false;
+
+#define DEFAULT_PRESENCE_HOLD_TIME_MS 0
+uint32_t gPresenceHoldTimeMs = DEFAULT_PRESENCE_HOLD_TIME_MS;
 
 void usage()
 {
-    cout << "usage: orchagent [-h] [-b batch_size] [-m MAC] [-i INST_ID]" << endl;
+    cout << "usage: orchagent [-h] [-b batch_size] [-m MAC] [-i INST_ID] [-s] [-r] [-w] [-p hold_ms] [-l slow_ms]" << endl;
     cout << "    -h: display this message" << endl;
     cout << "    -b batch_size: set consumer table pop operation batch size (default 128)" << endl;
     cout << "    -i INST_ID: set the ASIC instance_id in multi-asic platform" << endl;
     cout << "    -c flexcounter_json_filename: flexcounter json filename" << endl;
+    cout << "    -s: publish a single result per operation-id instead of one per field" << endl;
+    cout << "    -r: keep the flex counters of the previous run and only remove the stale ones" << endl;
+    cout << "    -w: warm start, keep the OTAI objects of the previous run and only set the changed attributes" << endl;
+    cout << "    -p hold_ms: apply a presence change once stable for hold_ms (default 0, disabled)" << endl;
+    cout << "    -l slow_ms: log the OTAI calls taking slow_ms or more (default 100)" << endl;
 }
 
 
@@ -61,7 +74,7 @@ int main(int argc, char **argv)
 
     int opt;
 
-    while ((opt = getopt(argc, argv, "b:m:f:d:i:h:c:")) != -1)
+    while ((opt = getopt(argc, argv, "b:m:f:d:i:h:c:srwp:l:")) != -1)
     {
         switch (opt)
         {
@@ -80,6 +93,23 @@ int main(int argc, char **argv)
                 gFlexcounterJsonFile = optarg;
             }
             break;
+        case 's':
+            gResultSummaryMode = true;
+            break;
+        case 'r':
+            gFlexCounterReconcile = true;
+            break;
+        case 'w':
+            /* The flex counters of the kept objects are kept as well */
+            gWarmStart = true;
+            gFlexCounterReconcile = true;
+            break;
+        case 'p':
+            gPresenceHoldTimeMs = static_cast<uint32_t>(atoi(optarg));
+            break;
+        case 'l':
+            OtaiApiStats::getInstance().setSlowThreshold(static_cast<uint64_t>(atoi(optarg)));
+            break;
         default: /* '?' */
             exit(EXIT_FAILURE);
         }
@@ -91,11 +121,11 @@ int main(int argc, char **argv)
 
 
     /* Initialize orchestration components */
-    DBConnector appl_db("APPL_DB", 0);
-    DBConnector config_db("CONFIG_DB", 0);
-    DBConnector state_db("STATE_DB", 0);
+    auto appl_db = DBConnectorPool::getConnector("APPL_DB");
+    auto config_db = DBConnectorPool::getConnector("CONFIG_DB");
+    auto state_db = DBConnectorPool::getConnector("STATE_DB");
 
-    auto orchDaemon = make_shared<OrchDaemon>(&appl_db, &config_db, &state_db);
+    auto orchDaemon = make_shared<OrchDaemon>(appl_db.get(), config_db.get(), state_db.get());
 
     if (!orchDaemon->init())
     {
@@ -103,6 +133,11 @@ int main(int argc, char **argv)
         exit(EXIT_FAILURE);
     }
 
+    if (gWarmStart)
+    {
+        orchDaemon->warmRestore();
+    }
+
     orchDaemon->start();
 
     return 0;
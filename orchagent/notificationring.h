@@ -0,0 +1,101 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// NotificationRing is a bounded lock-free multi-producer single-consumer
+// queue. Producers are the OTAI notification threads, the consumer is the
+// orchagent event loop. push() never blocks and fails when the ring is full.
+//
+// Every cell carries a sequence number: a cell at position pos is free for
+// the producer when seq == pos, and holds a value for the consumer when
+// seq == pos + 1.
+template <typename T, size_t N>
+class NotificationRing
+{
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "ring size must be a power of two");
+
+public:
+    NotificationRing()
+    {
+        for (size_t i = 0; i < N; i++)
+        {
+            m_cells[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    NotificationRing(const NotificationRing&) = delete;
+    NotificationRing& operator=(const NotificationRing&) = delete;
+
+    bool push(const T &value)
+    {
+        Cell *cell;
+        size_t pos = m_tail.load(std::memory_order_relaxed);
+
+        while (true)
+        {
+            cell = &m_cells[pos & (N - 1)];
+            size_t seq = cell->seq.load(std::memory_order_acquire);
+
+            if (seq == pos)
+            {
+                if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (seq < pos)
+            {
+                /* The consumer has not released this cell yet, ring is full */
+                return false;
+            }
+            else
+            {
+                pos = m_tail.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->value = value;
+        cell->seq.store(pos + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    bool pop(T &value)
+    {
+        Cell &cell = m_cells[m_head & (N - 1)];
+
+        if (cell.seq.load(std::memory_order_acquire) != m_head + 1)
+        {
+            return false;
+        }
+
+        value = cell.value;
+        cell.seq.store(m_head + N, std::memory_order_release);
+        m_head++;
+
+        return true;
+    }
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> seq;
+        T value;
+    };
+
+    Cell m_cells[N];
+
+    /*
+     * Keep the producer and consumer positions on separate cache lines.
+     * Padding is used instead of alignas() so the owner can still be
+     * allocated with a plain new.
+     */
+    char m_pad0[64];
+    std::atomic<size_t> m_tail = { 0 };
+    char m_pad1[64];
+
+    /* Only touched by the consumer */
+    size_t m_head = 0;
+};
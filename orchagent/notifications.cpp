@@ -10,10 +10,13 @@ extern "C" {
 #include "orchfsm.h"
 #include "notificationproducer.h"
 #include "otai_serialize.h"
+#include "otainotificationorch.h"
 
 using namespace std;
 using namespace swss;
 
+extern OtaiNotificationOrch *gOtaiNotificationOrch;
+
 void onLinecardAlarmNotify()
 {
     SWSS_LOG_ENTER();
@@ -43,24 +46,30 @@ void onLinecardActive()
 #endif
 }
 
+/*
+ * The callbacks below run on the OTAI notification thread. They only hand
+ * the notification over to OtaiNotificationOrch, which handles it in the
+ * orchagent event loop.
+ */
 void onLinecardStateChange(
         _In_ otai_object_id_t linecard_id,
         _In_ otai_oper_status_t linecard_oper_status)
 {
-    SWSS_LOG_ENTER();
+    if (gOtaiNotificationOrch == NULL)
+    {
+        SWSS_LOG_ERROR("Notification dropped, orch is not initialized");
+        return;
+    }
 
-    SWSS_LOG_NOTICE("linecard state change oper_status=%d", linecard_oper_status);
+    OtaiNotification notification;
 
-    if (linecard_oper_status == OTAI_OPER_STATUS_ACTIVE)
-    {
-        OrchFSM::setState(ORCH_STATE_WORK);
+    notification.enqueued = chrono::steady_clock::now();
+    notification.type = OTAI_NOTIFICATION_LINECARD_STATE_CHANGE;
+    notification.linecard_id = linecard_id;
+    notification.object_id = linecard_id;
+    notification.status = linecard_oper_status;
 
-        onLinecardActive();
-    }
-    else if (linecard_oper_status == OTAI_OPER_STATUS_INACTIVE)
-    {
-        OrchFSM::setState(ORCH_STATE_PAUSE);
-    }
+    gOtaiNotificationOrch->enqueue(notification);
 }
 
 void onOcmSpectrumPowerNotify(
@@ -68,28 +77,21 @@ void onOcmSpectrumPowerNotify(
         _In_ otai_object_id_t ocm_id,
         _In_ otai_spectrum_power_t ocm_result)
 {
-    SWSS_LOG_ENTER();
-
-    DBConnector appl_db("APPL_DB", 0);
-    DBConnector counters_db("COUNTERS_DB", 0);
-
-    NotificationProducer notify(&appl_db, OT_OCM_REPLY);
-
-    std::string strVid = otai_serialize_object_id(ocm_id);
-
-    auto key = counters_db.hget(COUNTERS_OT_OCM_NAME_MAP, strVid);
-    if (key == nullptr)
+    if (gOtaiNotificationOrch == NULL)
     {
+        SWSS_LOG_ERROR("Notification dropped, orch is not initialized");
         return;
     }
 
-    SWSS_LOG_DEBUG("orch receive ocm notification, %s", key->c_str());
+    OtaiNotification notification;
 
-    std::string op("SUCCESS");
-    std::string data(*key);
-    std::vector<swss::FieldValueTuple> values;
+    notification.enqueued = chrono::steady_clock::now();
+    notification.type = OTAI_NOTIFICATION_OCM_SPECTRUM_POWER;
+    notification.linecard_id = linecard_id;
+    notification.object_id = ocm_id;
+    notification.status = 0;
 
-    notify.send(op, data, values);
+    gOtaiNotificationOrch->enqueue(notification);
 }
 
 void onOtdrResultNotify(
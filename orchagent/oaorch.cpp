@@ -22,8 +22,6 @@ using namespace std;
 using namespace swss;
 
 extern FlexCounterOrch *gFlexCounterOrch;
-extern std::unordered_set<std::string> oa_counter_ids_status;
-extern std::unordered_set<std::string> oa_counter_ids_gauge;
 
 vector<otai_attr_id_t> g_oa_cfg_attrs =
 {
@@ -80,7 +78,7 @@ OaOrch::OaOrch(DBConnector *db, const vector<string> &table_names)
 
 void OaOrch::setFlexCounter(otai_object_id_t id, vector<otai_attribute_t> &attrs)
 {
-    gFlexCounterOrch->getStatusGroup()->setCounterIdList(id, CounterType::OA_STATUS, oa_counter_ids_status);
-    gFlexCounterOrch->getGaugeGroup()->setCounterIdList(id, CounterType::OA_GAUGE, oa_counter_ids_gauge);
+    gFlexCounterOrch->setCounterIdList(id, CounterType::OA_STATUS);
+    gFlexCounterOrch->setCounterIdList(id, CounterType::OA_GAUGE);
 }
 
@@ -23,9 +23,6 @@ extern FlexCounterOrch* gFlexCounterOrch;
 using namespace std;
 
 extern FlexCounterOrch* gFlexCounterOrch;
-extern std::unordered_set<std::string> opticalch_counter_ids_status;
-extern std::unordered_set<std::string> opticalch_counter_ids_gauge;
-extern std::unordered_set<std::string> opticalch_counter_ids_counter;
 
 vector<otai_attr_id_t> g_och_cfg_attrs =
 {
@@ -65,15 +62,13 @@ OchOrch::OchOrch(DBConnector *db, std::vector<TableConnector>& connectors)
 
 void OchOrch::setFlexCounter(otai_object_id_t id, vector<otai_attribute_t> &attrs)
 {
-    gFlexCounterOrch->getStatusGroup()->setCounterIdList(id, CounterType::OPTICALCH_STATUS, opticalch_counter_ids_status);
-    gFlexCounterOrch->getGaugeGroup()->setCounterIdList(id, CounterType::OPTICALCH_GAUGE, opticalch_counter_ids_gauge);
-    gFlexCounterOrch->getCounterGroup()->setCounterIdList(id, CounterType::OPTICALCH_COUNTER, opticalch_counter_ids_counter);
+    gFlexCounterOrch->setCounterIdList(id, CounterType::OPTICALCH_STATUS);
+    gFlexCounterOrch->setCounterIdList(id, CounterType::OPTICALCH_GAUGE);
+    gFlexCounterOrch->setCounterIdList(id, CounterType::OPTICALCH_COUNTER);
 }
 
 void OchOrch::clearFlexCounter(otai_object_id_t id, string key)
 {
-    gFlexCounterOrch->getCounterGroup()->clearCounterIdList(id);
-    gFlexCounterOrch->getGaugeGroup()->clearCounterIdList(id);
-    gFlexCounterOrch->getStatusGroup()->clearCounterIdList(id);
+    gFlexCounterOrch->clearCounterIdList(id);
 }
 
@@ -24,7 +24,6 @@ using namespace std;
 using namespace swss;
 
 extern FlexCounterOrch *gFlexCounterOrch;
-extern std::unordered_set<std::string> ocm_counter_ids_status;
 
 vector<otai_attr_id_t> g_ocm_cfg_attrs =
 {
@@ -65,7 +64,7 @@ void OcmOrch::setFlexCounter(otai_object_id_t id, vector<otai_attribute_t> &attr
 {
     SWSS_LOG_ENTER();
 
-    gFlexCounterOrch->getStatusGroup()->setCounterIdList(id, CounterType::OCM_STATUS, ocm_counter_ids_status);
+    gFlexCounterOrch->setCounterIdList(id, CounterType::OCM_STATUS);
 }
 
 void OcmOrch::doTask(swss::NotificationConsumer &consumer)
@@ -93,7 +92,8 @@ void OcmOrch::doTask(swss::NotificationConsumer &consumer)
         return;
     }
 
-    if (m_key2oid.find(data) == m_key2oid.end())
+    otai_object_id_t oid;
+    if (!getObjectId(data, oid))
     {
         op_ret = "FAILED";
         m_notificationProducer->send(op_ret, data, values);
@@ -102,32 +102,31 @@ void OcmOrch::doTask(swss::NotificationConsumer &consumer)
     }
 
     bool success = false;
+    std::string request_id;
 
     if (op == "set")
     {
-        otai_object_id_t oid = m_key2oid[data];
-
         for (unsigned i = 0; i < values.size(); i++)
         {
             std::string &value = fvValue(values[i]);
             std::string &field = fvField(values[i]);
 
-            if (m_irrecoverableAttrs.find(field) == m_irrecoverableAttrs.end())
+            if (field == "request-id")
             {
-                success = false;
-                break;
+                request_id = value;
+                continue;
             }
 
-            if (m_createandsetAttrs.find(field) == m_createandsetAttrs.end())
+            auto desc = getAttrDesc(field);
+            if (desc == NULL || !desc->irrecoverable || !desc->createandset)
             {
                 success = false;
                 break;
             }
 
             otai_attribute_t attr;
-            attr.id = m_createandsetAttrs[field];
 
-            if (translateOtaiObjectAttr(field, value, attr) == false)
+            if (translateOtaiObjectAttr(*desc, value, attr) == false)
             {
                 success = false;
                 break;
@@ -161,10 +160,34 @@ void OcmOrch::doTask(swss::NotificationConsumer &consumer)
         op_ret = "FAILED";
         m_notificationProducer->send(op_ret, data, values);
     }
+    else if (!request_id.empty())
+    {
+        auto it = m_scanRequestIds.find(data);
+        if (it != m_scanRequestIds.end())
+        {
+            SWSS_LOG_WARN("Scan %s of %s superseded by scan %s",
+                          it->second.c_str(), data.c_str(), request_id.c_str());
+        }
+        m_scanRequestIds[data] = request_id;
+    }
 
     return;
 }
 
+bool OcmOrch::takeScanRequestId(const string &key, string &request_id)
+{
+    auto it = m_scanRequestIds.find(key);
+    if (it == m_scanRequestIds.end())
+    {
+        return false;
+    }
+
+    request_id = it->second;
+    m_scanRequestIds.erase(it);
+
+    return true;
+}
+
 void OcmOrch::setSelfProcessAttrs(const string &key,
                                   vector<FieldValueTuple> &auxiliary_fv,
                                   string operation_id)
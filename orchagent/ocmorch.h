@@ -14,5 +14,17 @@ public:
     void setSelfProcessAttrs(const string &key,
                              vector<FieldValueTuple> &auxiliary_fv,
                              string operation_id="");
+
+    bool takeScanRequestId(const string &key, string &request_id);
+
+private:
+    /*
+     * request-id of the scan in progress on each OCM, stamped when the scan
+     * is issued and returned with the reply sent when the spectrum power
+     * notification arrives. A notification without a scan in progress is
+     * not replied. The notification does not tell which scan it ends, the
+     * late one of a superseded scan is taken for the new scan.
+     */
+    map<string, string> m_scanRequestIds;
 };
 
@@ -2,6 +2,7 @@
 #include <iostream>
 #include <string>
 #include <inttypes.h>
+#include <algorithm>
 #include <sys/time.h>
 #include "timestamp.h"
 #include "orch.h"
@@ -10,6 +11,8 @@
 #include "tokenize.h"
 #include "logger.h"
 #include "consumerstatetable.h"
+#include "latencytracer.h"
+#include "rediscommand.h"
 
 using namespace swss;
 using namespace std;
@@ -63,81 +66,22 @@ void Consumer::addToSync(const KeyOpFieldsValuesTuple &entry)
 {
     SWSS_LOG_ENTER();
 
-
-    string key = kfvKey(entry);
-    string op  = kfvOp(entry);
-
     /*
-    * m_toSync is a multimap which will allow one key with multiple values,
-    * Also, the order of the key-value pairs whose keys compare equivalent
-    * is the order of insertion and does not change. (since C++11)
-    */
-
-    /* If a new task comes we directly put it into getConsumerTable().m_toSync map */
-    if (m_toSync.find(key) == m_toSync.end())
-    {
-        m_toSync.emplace(key, entry);
-    }
-
-    /* if a DEL task comes, we overwrite the old key */
-    else if (op == DEL_COMMAND)
+     * m_toSync keeps at most a DEL and a SET task per key, a new DEL
+     * overwrites the pending tasks and a new SET is merged into the
+     * pending SET task. See SyncMap::addTask().
+     *
+     * The parked tasks of the key go back first, the new task may be the
+     * one that makes them succeed.
+     */
+    if (!m_retryTasks.empty() && releaseRetry(kfvKey(entry)))
     {
-        m_toSync.erase(key);
-        m_toSync.emplace(key, entry);
+        m_updateReleases++;
     }
-    else
-    {
-        /*
-        * Now we are trying to add the key-value with SET.
-        * We maintain maximum two values per key.
-        * In case there is one key-value, it should be DEL or SET
-        * In case there are two key-value pairs, it should be DEL then SET
-        * The code logic is following:
-        * We iterate the values with the key, we skip the value with DEL and then
-        * check if that was the only one (I,E, the iter pointer now points to end or next key),
-        * in such case, we insert the key-value with SET.
-        * If there was a SET already (I,E, the pointer still points to the same key), we combine the kfv.
-        */
-        auto ret = m_toSync.equal_range(key);
-        auto iter = ret.first;
-        for (; iter != ret.second; ++iter)
-        {
-            auto old_op = kfvOp(iter->second);
-            if (old_op == SET_COMMAND)
-                break;
-        }
-        if (iter == ret.second)
-        {
-            m_toSync.emplace(key, entry);
-        }
-        else
-        {
-            KeyOpFieldsValuesTuple existing_data = iter->second;
-
-            auto new_values = kfvFieldsValues(entry);
-            auto existing_values = kfvFieldsValues(existing_data);
 
+    m_toSync.addTask(entry);
 
-            for (auto it : new_values)
-            {
-                string field = fvField(it);
-                string value = fvValue(it);
-
-                auto iu = existing_values.begin();
-                while (iu != existing_values.end())
-                {
-                    string ofield = fvField(*iu);
-                    if (field == ofield)
-                        iu = existing_values.erase(iu);
-                    else
-                        iu++;
-                }
-                existing_values.push_back(FieldValueTuple(field, value));
-            }
-            iter->second = KeyOpFieldsValuesTuple(key, op, existing_values);
-        }
-    }
-
+    setDirty(true);
 }
 
 size_t Consumer::addToSync(const std::deque<KeyOpFieldsValuesTuple> &entries)
@@ -203,15 +147,397 @@ void Consumer::execute()
     std::deque<KeyOpFieldsValuesTuple> entries;
     getConsumerTable()->pops(entries);
 
+    /*
+     * Northbound writes are traced from here to their result. The receive
+     * time stamped by configsyncd is only meant for the tracer, it is taken
+     * out of the task and removed from the table in one batch per iteration.
+     */
+    vector<pair<string, string>> stamps;
+    vector<pair<string, string>> traced_tasks;
+
+    for (auto &entry : entries)
+    {
+        string operation_id;
+        uint64_t receive_us = 0;
+        auto &fvs = kfvFieldsValues(entry);
+
+        for (auto fv = fvs.begin(); fv != fvs.end();)
+        {
+            if (fvField(*fv) == "operation-ts")
+            {
+                receive_us = strtoull(fvValue(*fv).c_str(), NULL, 10);
+                stamps.emplace_back(kfvKey(entry), fvValue(*fv));
+                fv = fvs.erase(fv);
+                continue;
+            }
+
+            if (fvField(*fv) == "operation-id")
+            {
+                operation_id = fvValue(*fv);
+            }
+            fv++;
+        }
+
+        if (!operation_id.empty())
+        {
+            LatencyTracer::getInstance().begin(operation_id, getTableName(), receive_us);
+            traced_tasks.emplace_back(kfvKey(entry), operation_id);
+        }
+    }
+
     addToSync(entries);
 
     drain();
+
+    /*
+     * A task done without publishing on its operation-id ends no trace. A
+     * parked task keeps its trace until it is retried.
+     */
+    for (auto &task : traced_tasks)
+    {
+        if (m_toSync.find(task.first) == m_toSync.end() &&
+            m_retryTasks.find(task.first) == m_retryTasks.end())
+        {
+            LatencyTracer::getInstance().abandon(task.second);
+        }
+    }
+
+    if (!stamps.empty())
+    {
+        deleteStamps(stamps);
+    }
+}
+
+map<string, Consumer::StampPipeline> Consumer::m_stampPipelines;
+
+/* Deletes the field only if a newer write did not stamp it again */
+static const string deleteStampScript =
+    "if redis.call('HGET', KEYS[1], 'operation-ts') == ARGV[1] then "
+    "return redis.call('HDEL', KEYS[1], 'operation-ts') end "
+    "return 0";
+
+void Consumer::deleteStamps(const vector<pair<string, string>> &stamps)
+{
+    DBConnector *db = getConsumerTable()->getDbConnector();
+    StampPipeline &stamp_pipeline = m_stampPipelines[db->getDbName()];
+
+    if (!stamp_pipeline.pipeline)
+    {
+        stamp_pipeline.pipeline.reset(new RedisPipeline(db));
+        stamp_pipeline.sha = stamp_pipeline.pipeline->loadRedisScript(deleteStampScript);
+    }
+
+    for (auto &stamp : stamps)
+    {
+        RedisCommand command;
+        command.format("EVALSHA %s 1 %s %s", stamp_pipeline.sha.c_str(),
+                       getConsumerTable()->getKeyName(stamp.first).c_str(), stamp.second.c_str());
+        stamp_pipeline.pipeline->push(command, REDIS_REPLY_INTEGER);
+        stamp_pipeline.pending++;
+    }
+}
+
+void Consumer::flushStampDeletions()
+{
+    for (auto &it : m_stampPipelines)
+    {
+        if (it.second.pending == 0)
+        {
+            continue;
+        }
+
+        it.second.pipeline->flush();
+        it.second.pending = 0;
+    }
 }
 
 void Consumer::drain()
 {
+    if (!m_dirty)
+        return;
+
     if (!m_toSync.empty())
         m_orch->doTask(*this);
+
+    if (!m_releasedKeys.empty())
+        finishRetries();
+
+    /* Tasks left in m_toSync keep the consumer dirty, they will be retried */
+    setDirty(!m_toSync.empty());
+}
+
+void Consumer::setDirty(bool dirty)
+{
+    if (m_dirty == dirty)
+    {
+        return;
+    }
+
+    m_dirty = dirty;
+
+    if (dirty)
+    {
+        m_orch->m_dirtyConsumers++;
+    }
+    else
+    {
+        m_orch->m_dirtyConsumers--;
+    }
+}
+
+SyncMap::iterator Consumer::retryLater(SyncMap::iterator it,
+                                      const string &reason,
+                                      const string &dependency)
+{
+    SWSS_LOG_ENTER();
+
+    string key = it->first;
+    auto next = std::next(it);
+
+    /* Park all the tasks of the key, a SET must not overtake its DEL */
+    for (auto task = m_toSync.find(key); task != m_toSync.end(); task = m_toSync.find(key))
+    {
+        if (task == next)
+        {
+            ++next;
+        }
+
+        m_retryTasks.addTask(task->second);
+        m_toSync.erase(task);
+    }
+
+    auto now = chrono::steady_clock::now();
+    RetryState &state = m_retryStates[key];
+
+    if (state.attempts == 0)
+    {
+        state.first = now;
+    }
+
+    uint32_t shift = min(state.attempts, 16u);
+    uint64_t backoff = min<uint64_t>(RETRY_BACKOFF_MAX_MS, (uint64_t)RETRY_BACKOFF_INITIAL_MS << shift);
+
+    state.attempts++;
+    state.reason = reason;
+    state.dependency = dependency;
+    state.parked = true;
+    state.due = now + chrono::milliseconds(backoff);
+
+    m_retryCount++;
+
+    RetryTimer::getInstance().schedule(this, key, state.due);
+
+    SWSS_LOG_INFO("Retry %s:%s in %" PRIu64 " ms, attempt %u: %s",
+                  getTableName().c_str(), key.c_str(), backoff, state.attempts, reason.c_str());
+
+    return next;
+}
+
+bool Consumer::releaseRetry(const string &key)
+{
+    auto st = m_retryStates.find(key);
+    if (st == m_retryStates.end() || !st->second.parked)
+    {
+        return false;
+    }
+
+    st->second.parked = false;
+
+    for (auto task = m_retryTasks.find(key); task != m_retryTasks.end(); task = m_retryTasks.find(key))
+    {
+        m_toSync.addTask(task->second);
+        m_retryTasks.erase(task);
+    }
+
+    m_releasedKeys.push_back(key);
+    setDirty(true);
+
+    return true;
+}
+
+void Consumer::releaseDueRetry(const string &key, chrono::steady_clock::time_point now)
+{
+    auto st = m_retryStates.find(key);
+    if (st == m_retryStates.end() || !st->second.parked || st->second.due > now)
+    {
+        return;
+    }
+
+    releaseRetry(key);
+    m_timerReleases++;
+
+    drain();
+}
+
+size_t Consumer::releaseRetries(const string &dependency)
+{
+    SWSS_LOG_ENTER();
+
+    vector<string> keys;
+
+    for (auto &it : m_retryStates)
+    {
+        if (it.second.parked && it.second.dependency == dependency)
+        {
+            keys.push_back(it.first);
+        }
+    }
+
+    for (auto &key : keys)
+    {
+        releaseRetry(key);
+    }
+
+    if (!keys.empty())
+    {
+        m_dependencyReleases += keys.size();
+
+        SWSS_LOG_INFO("Released %zu %s tasks waiting on %s",
+                      keys.size(), getTableName().c_str(), dependency.c_str());
+
+        drain();
+    }
+
+    return keys.size();
+}
+
+/*
+ * Account the released keys whose tasks have been processed. A key parked
+ * again is dropped from the list, a key whose tasks were left in m_toSync
+ * is checked again on the next drain.
+ */
+void Consumer::finishRetries()
+{
+    auto now = chrono::steady_clock::now();
+    vector<string> pending;
+
+    for (auto &key : m_releasedKeys)
+    {
+        auto st = m_retryStates.find(key);
+        if (st == m_retryStates.end() || st->second.parked)
+        {
+            continue;
+        }
+
+        if (m_toSync.count(key) != 0)
+        {
+            pending.push_back(key);
+            continue;
+        }
+
+        uint64_t wait = (uint64_t)chrono::duration_cast<chrono::milliseconds>(now - st->second.first).count();
+
+        m_retryDone++;
+        m_retryWaitMsTotal += wait;
+        m_retryWaitMsMax = max(m_retryWaitMsMax, wait);
+
+        m_retryStates.erase(st);
+    }
+
+    m_releasedKeys.swap(pending);
+}
+
+void Consumer::getRetryStats(vector<FieldValueTuple> &fvs) const
+{
+    if (m_retryCount == 0)
+    {
+        return;
+    }
+
+    string prefix = getTableName() + "|";
+
+    fvs.emplace_back(prefix + "parked", to_string(m_retryTasks.size()));
+    fvs.emplace_back(prefix + "retries", to_string(m_retryCount));
+    fvs.emplace_back(prefix + "timer-releases", to_string(m_timerReleases));
+    fvs.emplace_back(prefix + "dependency-releases", to_string(m_dependencyReleases));
+    fvs.emplace_back(prefix + "update-releases", to_string(m_updateReleases));
+    fvs.emplace_back(prefix + "done", to_string(m_retryDone));
+    fvs.emplace_back(prefix + "wait-avg-ms", to_string(m_retryDone ? m_retryWaitMsTotal / m_retryDone : 0));
+    fvs.emplace_back(prefix + "wait-max-ms", to_string(m_retryWaitMsMax));
+}
+
+RetryTimer &RetryTimer::getInstance()
+{
+    static RetryTimer instance;
+    return instance;
+}
+
+RetryTimer::RetryTimer() :
+    Executor(new SelectableTimer(timespec { .tv_sec = 0, .tv_nsec = RETRY_TICK_MS * 1000000 }),
+             NULL, "RETRY_TIMER"),
+    m_epoch(chrono::steady_clock::now())
+{
+}
+
+void RetryTimer::schedule(Consumer *consumer, const string &key, chrono::steady_clock::time_point due)
+{
+    auto delay = chrono::duration_cast<chrono::milliseconds>(due - m_epoch).count();
+    uint64_t tick = delay > 0 ? ((uint64_t)delay + RETRY_TICK_MS - 1) / RETRY_TICK_MS : 0;
+
+    m_slots[tick].emplace_back(consumer, key);
+
+    arm();
+}
+
+void RetryTimer::arm()
+{
+    if (m_slots.empty())
+    {
+        getTimer()->stop();
+        m_armedTick = 0;
+        return;
+    }
+
+    uint64_t tick = m_slots.begin()->first;
+    if (tick == m_armedTick)
+    {
+        return;
+    }
+
+    auto expiry = m_epoch + chrono::milliseconds(tick * RETRY_TICK_MS);
+    auto delay = chrono::duration_cast<chrono::milliseconds>(expiry - chrono::steady_clock::now()).count();
+    if (delay < 1)
+    {
+        delay = 1;
+    }
+
+    timespec interval;
+    interval.tv_sec = delay / 1000;
+    interval.tv_nsec = (delay % 1000) * 1000000;
+
+    getTimer()->setInterval(interval);
+    getTimer()->start();
+    m_armedTick = tick;
+}
+
+void RetryTimer::execute()
+{
+    SWSS_LOG_ENTER();
+
+    auto now = chrono::steady_clock::now();
+    vector<pair<Consumer *, string>> due;
+
+    /* Releasing may park tasks again, take the due slots out first */
+    while (!m_slots.empty())
+    {
+        auto slot = m_slots.begin();
+        if (m_epoch + chrono::milliseconds(slot->first * RETRY_TICK_MS) > now)
+        {
+            break;
+        }
+
+        due.insert(due.end(), slot->second.begin(), slot->second.end());
+        m_slots.erase(slot);
+    }
+
+    m_armedTick = 0;
+
+    for (auto &it : due)
+    {
+        it.first->releaseDueRetry(it.second, now);
+    }
+
+    arm();
 }
 
 string Consumer::dumpTuple(const KeyOpFieldsValuesTuple &tuple)
@@ -236,6 +562,11 @@ void Consumer::dumpPendingTasks(vector<string> &ts)
 
         ts.push_back(s);
     }
+
+    for (auto &tm : m_retryTasks)
+    {
+        ts.push_back(dumpTuple(tm.second) + "|parked:" + m_retryStates[tm.first].reason);
+    }
 }
 
 size_t Orch::addExistingData(const string& tableName)
@@ -490,12 +821,49 @@ string Orch::objectReferenceInfo(
 
 void Orch::doTask()
 {
+    /* Nothing was queued or left for retry since the last drain */
+    if (m_dirtyConsumers == 0)
+    {
+        m_skippedDrainCount++;
+        return;
+    }
+
+    m_drainCount++;
+
     for (auto &it : m_consumerMap)
     {
         it.second->drain();
     }
 }
 
+size_t Orch::releaseRetries(const string &dependency)
+{
+    size_t released = 0;
+
+    for (auto &it : m_consumerMap)
+    {
+        Consumer* consumer = dynamic_cast<Consumer *>(it.second.get());
+        if (consumer != NULL)
+        {
+            released += consumer->releaseRetries(dependency);
+        }
+    }
+
+    return released;
+}
+
+void Orch::getRetryStats(vector<FieldValueTuple> &fvs)
+{
+    for (auto &it : m_consumerMap)
+    {
+        Consumer* consumer = dynamic_cast<Consumer *>(it.second.get());
+        if (consumer != NULL)
+        {
+            consumer->getRetryStats(fvs);
+        }
+    }
+}
+
 void Orch::dumpPendingTasks(vector<string> &ts)
 {
     for (auto &it : m_consumerMap)
@@ -691,7 +1059,7 @@ void Orch2::doTask(Consumer &consumer)
         }
         else
         {
-            ++it;
+            it = consumer.retryLater(it, "operation not done");
         }
     }
 }
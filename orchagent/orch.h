@@ -7,6 +7,8 @@
 #include <set>
 #include <memory>
 #include <utility>
+#include <chrono>
+#include <vector>
 
 extern "C" {
 #include "otai.h"
@@ -14,12 +16,15 @@ extern "C" {
 }
 
 #include "dbconnector.h"
+#include "redispipeline.h"
 #include "table.h"
 #include "consumertable.h"
 #include "consumerstatetable.h"
 #include "notificationconsumer.h"
 #include "selectabletimer.h"
+#include "selectableevent.h"
 #include "macaddress.h"
+#include "syncmap.h"
 
 const char delimiter           = ':';
 const char list_item_delimiter = ',';
@@ -35,6 +40,13 @@ const char state_db_key_delimiter  = '|';
 #define CONFIGDB_KEY_SEPARATOR "|"
 #define DEFAULT_KEY_SEPARATOR  ":"
 
+/* Backoff of a task left for retry, doubled on each attempt up to the cap */
+#define RETRY_BACKOFF_INITIAL_MS 100
+#define RETRY_BACKOFF_MAX_MS     5000
+
+/* Granularity of the retry due times, see RetryTimer */
+#define RETRY_TICK_MS 50
+
 const int default_orch_pri = 0;
 
 typedef enum
@@ -64,11 +76,6 @@ typedef std::map<std::string, object_reference_map*> type_map;
 typedef std::map<std::string, otai_object_id_t> object_map;
 typedef std::pair<std::string, otai_object_id_t> object_map_pair;
 
-// Use multimap to support multiple OpFieldsValues for the same key (e,g, DEL and SET)
-// The order of the key-value pairs whose keys compare equivalent is the order of
-// insertion and does not change. (since C++11)
-typedef std::multimap<std::string, swss::KeyOpFieldsValuesTuple> SyncMap;
-
 typedef std::pair<std::string, int> table_name_with_pri_t;
 
 class Orch;
@@ -120,6 +127,21 @@ protected:
     swss::Selectable *getSelectable() const { return m_selectable; }
 };
 
+/*
+ * Retry state of a key whose tasks were parked by Consumer::retryLater().
+ * The state is kept until the tasks of the key are processed, so that the
+ * backoff grows while the key keeps failing.
+ */
+struct RetryState
+{
+    std::string reason;
+    std::string dependency;
+    uint32_t attempts = 0;
+    bool parked = false;
+    std::chrono::steady_clock::time_point first;
+    std::chrono::steady_clock::time_point due;
+};
+
 class Consumer : public Executor {
 public:
     Consumer(swss::ConsumerTableBase *select, Orch *orch, const std::string &name)
@@ -163,6 +185,101 @@ public:
 
     // Returns: the number of entries added to m_toSync
     size_t addToSync(const std::deque<swss::KeyOpFieldsValuesTuple> &entries);
+
+    /* Whether m_toSync holds tasks that still need to be drained */
+    bool isDirty() const { return m_dirty; }
+
+    /*
+     * Park the tasks of the key of it out of m_toSync instead of leaving
+     * them to be retried on every drain. They come back when the backoff
+     * of the key expires, when the dependency is released through
+     * Orch::releaseRetries() or when a new task arrives for the key.
+     * Returns the iterator following it, the parked tasks are skipped.
+     */
+    SyncMap::iterator retryLater(SyncMap::iterator it,
+                                 const std::string &reason,
+                                 const std::string &dependency = "");
+
+    /* Called by RetryTimer when the backoff of the key may have expired */
+    void releaseDueRetry(const std::string &key, std::chrono::steady_clock::time_point now);
+
+    size_t releaseRetries(const std::string &dependency);
+
+    size_t getParkedCount() const { return m_retryTasks.size(); }
+
+    void getRetryStats(std::vector<swss::FieldValueTuple> &fvs) const;
+
+    /* Send the deletions of the operation-ts stamps queued by execute() */
+    static void flushStampDeletions();
+
+private:
+    bool m_dirty = false;
+
+    void deleteStamps(const std::vector<std::pair<std::string, std::string>> &stamps);
+
+    /*
+     * The operation-ts stamps are deleted from the tables through one
+     * pipeline per database, flushed once per event loop iteration. A stamp
+     * is only deleted while it is still the popped one, see deleteStamps().
+     */
+    struct StampPipeline
+    {
+        std::unique_ptr<swss::RedisPipeline> pipeline;
+        std::string sha;
+        size_t pending = 0;
+    };
+
+    static std::map<std::string, StampPipeline> m_stampPipelines;
+
+    void setDirty(bool dirty);
+
+    bool releaseRetry(const std::string &key);
+    void finishRetries();
+
+    SyncMap m_retryTasks;
+    std::unordered_map<std::string, RetryState> m_retryStates;
+    std::vector<std::string> m_releasedKeys;
+
+    uint64_t m_retryCount = 0;
+    uint64_t m_timerReleases = 0;
+    uint64_t m_dependencyReleases = 0;
+    uint64_t m_updateReleases = 0;
+    uint64_t m_retryDone = 0;
+    uint64_t m_retryWaitMsTotal = 0;
+    uint64_t m_retryWaitMsMax = 0;
+};
+
+// RetryTimer wakes up the consumers whose parked tasks are due, it is shared
+// by all the orchs of the process and must be added to the Select of the
+// daemon.
+//
+// Due times are rounded up to RETRY_TICK_MS ticks. The keys due in the same
+// tick share a slot and a single timer expiry, and the timer is only armed
+// for the first non-empty slot, so parked tasks cost no wakeup until due.
+class RetryTimer : public Executor
+{
+public:
+    static RetryTimer &getInstance();
+
+    void schedule(Consumer *consumer,
+                  const std::string &key,
+                  std::chrono::steady_clock::time_point due);
+
+    void execute() override;
+
+private:
+    RetryTimer();
+
+    void arm();
+
+    swss::SelectableTimer *getTimer() const
+    {
+        return static_cast<swss::SelectableTimer *>(getSelectable());
+    }
+
+    std::chrono::steady_clock::time_point m_epoch;
+    std::map<uint64_t, std::vector<std::pair<Consumer *, std::string>>> m_slots;
+    uint64_t m_armedTick = 0;
 };
 
 typedef std::map<std::string, std::shared_ptr<Executor>> ConsumerMap;
@@ -199,13 +316,26 @@ public:
     // otherwise fallback to cold start
     virtual bool bake();
 
-    /* Iterate all consumers in m_consumerMap and run doTask(Consumer) */
+    /* Iterate dirty consumers in m_consumerMap and run doTask(Consumer) */
     virtual void doTask();
 
+    /* Whether any consumer still has tasks left in its m_toSync */
+    bool hasDirtyConsumers() const { return m_dirtyConsumers != 0; }
+
+    /* Number of doTask() passes that drained consumers or were skipped */
+    uint64_t getDrainCount() const { return m_drainCount; }
+    uint64_t getSkippedDrainCount() const { return m_skippedDrainCount; }
+
+    /* Release at once the parked tasks waiting on the dependency */
+    size_t releaseRetries(const std::string &dependency);
+
+    void getRetryStats(std::vector<swss::FieldValueTuple> &fvs);
+
     /* Run doTask against a specific executor */
     virtual void doTask(Consumer &consumer) = 0;
     virtual void doTask(swss::NotificationConsumer &consumer) { }
     virtual void doTask(swss::SelectableTimer &timer) { }
+    virtual void doTask(swss::SelectableEvent &event) { }
 
     void dumpPendingTasks(std::vector<std::string> &ts);
 protected:
@@ -225,6 +355,13 @@ protected:
     void addExecutor(Executor* executor);
     Executor *getExecutor(std::string executorName);
 private:
+    friend class Consumer;
+
+    /* Number of consumers marked dirty, maintained by Consumer::setDirty */
+    size_t m_dirtyConsumers = 0;
+    uint64_t m_drainCount = 0;
+    uint64_t m_skippedDrainCount = 0;
+
     void removeMeFromObjsReferencedByMe(type_map &type_maps, const std::string &table, const std::string &obj_name, const std::string &field, const std::string &old_referenced_obj_name);
     void addConsumer(swss::DBConnector *db, std::string tableName, int pri = default_orch_pri);
 };
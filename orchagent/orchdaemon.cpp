@@ -38,6 +38,10 @@ LinecardOrch* gLinecardOrch;
 Directory<Orch*> gDirectory;
 FlexCounterOrch* gFlexCounterOrch;
 DiagOrch* gDiagOrch;
+ResultPublisher* gResultPublisher;
+OtaiNotificationOrch* gOtaiNotificationOrch;
+
+extern bool gResultSummaryMode;
 
 OrchDaemon::OrchDaemon(DBConnector* applDb, DBConnector* configDb, DBConnector* stateDb) :
     m_applDb(applDb),
@@ -70,6 +74,11 @@ bool OrchDaemon::init()
 {
     SWSS_LOG_ENTER();
 
+    gResultPublisher = new ResultPublisher(m_stateDb, gResultSummaryMode);
+
+    /* Created first, the OTAI callbacks may fire as soon as the linecard is created */
+    gOtaiNotificationOrch = new OtaiNotificationOrch(m_applDb);
+
     TableConnector app_linecard_table(m_applDb, APP_OT_LINECARD_TABLE_NAME);
     TableConnector state_linecard_table(m_stateDb, STATE_OT_LINECARD_TABLE_NAME);
 
@@ -216,7 +225,8 @@ bool OrchDaemon::init()
                    gAttenuatorOrch,
                    gOcmOrch,
                    gOtdrOrch,
-                   gDiagOrch };
+                   gDiagOrch,
+                   gOtaiNotificationOrch };
 
     m_select = new Select();
 
@@ -227,9 +237,30 @@ bool OrchDaemon::init()
     gFlexCounterOrch = new FlexCounterOrch(m_configDb, flex_counter_tables);
     m_orchList.push_back(gFlexCounterOrch);
 
+    gDiagOrch->setOrchList(m_orchList);
+    gLinecardOrch->setOrchList(m_orchList);
+
     return true;
 }
 
+/*
+ * Restore the objects of the previous run and refill the consumers from the
+ * existing tables, the orchs then reconcile their configuration with the
+ * restored objects instead of creating them. Orchs are baked in the order
+ * of the orch list, the linecard first.
+ */
+void OrchDaemon::warmRestore()
+{
+    SWSS_LOG_ENTER();
+
+    SWSS_LOG_NOTICE("Warm start, restoring the objects of the previous run");
+
+    for (Orch* o : m_orchList)
+    {
+        o->bake();
+    }
+}
+
 /* Flush redis through otairedis interface */
 void OrchDaemon::flush()
 {
@@ -255,6 +286,8 @@ void OrchDaemon::start()
         m_select->addSelectables(o->getSelectables());
     }
 
+    m_select->addSelectable(&RetryTimer::getInstance());
+
     while (true)
     {
         Selectable* s;
@@ -276,18 +309,25 @@ void OrchDaemon::start()
              * requests live in it. When the daemon has nothing to do, it
              * is a good chance to flush the pipeline  */
             flush();
+            gFlexCounterOrch->flush();
+            Consumer::flushStampDeletions();
             continue;
         }
 
         auto* c = (Executor*)s;
         c->execute();
 
-        /* After each iteration, periodically check all m_toSync map to
-         * execute all the remaining tasks that need to be retried. */
-
-         /* TODO: Abstract Orch class to have a specific todo list */
+        /* After each iteration, drain the orchs whose consumers are dirty,
+         * i.e. have new tasks or tasks that need to be retried in m_toSync.
+         * Orchs without dirty consumers return immediately. */
         for (Orch* o : m_orchList)
             o->doTask();
+
+        /* Send the operation results, the flex counter registrations and
+         * the stamp deletions of this iteration in one pipeline each */
+        gResultPublisher->flush();
+        gFlexCounterOrch->flush();
+        Consumer::flushStampDeletions();
     }
 }
 
@@ -28,6 +28,8 @@
 #include "linecardorch.h"
 #include "flexcounterorch.h"
 #include "diagorch.h"
+#include "resultpublisher.h"
+#include "otainotificationorch.h"
 #include "directory.h"
 
 using namespace swss;
@@ -41,6 +43,7 @@ public:
 
     bool init();
     void start();
+    void warmRestore();
 private:
     DBConnector *m_applDb;
     DBConnector *m_configDb;
@@ -25,10 +25,39 @@ OrchFSM &OrchFSM::getInstance()
 
 void OrchFSM::setState(OrchState state)
 {
-    getInstance().m_state = state;
+    if (getInstance().m_state.exchange(state) != state)
+    {
+        wakeup();
+    }
 }
 
 OrchState OrchFSM::getState()
 {
     return getInstance().m_state;
 }
+
+void OrchFSM::wakeup()
+{
+    getInstance().m_wakeups++;
+
+    swss::SelectableEvent *event = getInstance().m_wakeupEvent;
+    if (event)
+    {
+        event->notify();
+    }
+}
+
+/* The executor wrapping the event deletes it, it lives as long as the orch */
+swss::SelectableEvent *OrchFSM::createWakeupEvent()
+{
+    swss::SelectableEvent *event = new swss::SelectableEvent();
+
+    getInstance().m_wakeupEvent = event;
+
+    return event;
+}
+
+uint64_t OrchFSM::getWakeupCount()
+{
+    return getInstance().m_wakeups;
+}
@@ -1,5 +1,7 @@
 #pragma once
 #include <atomic>
+#include <cstdint>
+#include "selectableevent.h"
 
 enum OrchState {
     ORCH_STATE_NOT_READY,
@@ -15,10 +17,23 @@ public:
     static void setState(OrchState state);
     static OrchState getState();
 
+    // Tasks gated on the orch state or on the flex counter init are left in
+    // m_toSync. A state change or the end of the flex counter init notifies
+    // the wakeup event, so that the event loop drains them right away
+    // instead of on the next unrelated event. The event is new-ed by
+    // createWakeupEvent() and owned by the Executor it is handed to.
+    static void wakeup();
+    static swss::SelectableEvent *createWakeupEvent();
+    static uint64_t getWakeupCount();
+
 private:
     OrchFSM() = default;
     ~OrchFSM() = default;
 
     std::atomic<OrchState> m_state = { ORCH_STATE_NOT_READY };
+
+    std::atomic<swss::SelectableEvent *> m_wakeupEvent = { nullptr };
+
+    std::atomic<uint64_t> m_wakeups = { 0 };
 };
 
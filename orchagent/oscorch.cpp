@@ -22,8 +22,6 @@ using namespace std;
 using namespace swss;
 
 extern FlexCounterOrch *gFlexCounterOrch;
-extern std::unordered_set<std::string> osc_counter_ids_status;
-extern std::unordered_set<std::string> osc_counter_ids_gauge;
 
 vector<otai_attr_id_t> g_osc_cfg_attrs =
 {
@@ -62,7 +60,7 @@ OscOrch::OscOrch(DBConnector *db, const vector<string> &table_names)
 
 void OscOrch::setFlexCounter(otai_object_id_t id, vector<otai_attribute_t> &attrs)
 {
-    gFlexCounterOrch->getStatusGroup()->setCounterIdList(id, CounterType::OSC_STATUS, osc_counter_ids_status);
-    gFlexCounterOrch->getGaugeGroup()->setCounterIdList(id, CounterType::OSC_GAUGE, osc_counter_ids_gauge);
+    gFlexCounterOrch->setCounterIdList(id, CounterType::OSC_STATUS);
+    gFlexCounterOrch->setCounterIdList(id, CounterType::OSC_GAUGE);
 }
 
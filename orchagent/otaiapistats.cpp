@@ -0,0 +1,295 @@
+/**
+ * Copyright (c) 2023 Alibaba Group Holding Limited
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABILITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ */
+
+#include <string>
+
+#include "otaiapistats.h"
+#include "otaihelper.h"
+#include "logger.h"
+
+using namespace std;
+using namespace swss;
+
+OtaiApiStats &OtaiApiStats::getInstance()
+{
+    static OtaiApiStats stats;
+
+    return stats;
+}
+
+size_t OtaiApiStats::getSlot(otai_attr_id_t attr_id)
+{
+    return attr_id < OTAI_API_STATS_MAX_ATTRS ? static_cast<size_t>(attr_id) : OTAI_API_STATS_OTHER_ATTR;
+}
+
+void OtaiApiStats::record(otai_object_type_t type, OtaiApiOp op, size_t slot,
+                          uint64_t us, otai_status_t status)
+{
+    if (type >= OTAI_OBJECT_TYPE_MAX || op >= OTAI_API_OP_MAX || slot >= OTAI_API_STATS_SLOTS)
+    {
+        return;
+    }
+
+    auto &entry = m_counters[type][op][slot];
+
+    /* Allocated on first use, the loser of a race frees its copy */
+    Counters *counters = entry.load(memory_order_acquire);
+    if (counters == NULL)
+    {
+        Counters *allocated = new Counters();
+        if (entry.compare_exchange_strong(counters, allocated, memory_order_acq_rel))
+        {
+            counters = allocated;
+        }
+        else
+        {
+            delete allocated;
+        }
+    }
+
+    counters->latency.record(us);
+    if (status != OTAI_STATUS_SUCCESS)
+    {
+        counters->errors.fetch_add(1, memory_order_relaxed);
+    }
+
+    if (us < m_slowThresholdUs.load(memory_order_relaxed))
+    {
+        return;
+    }
+
+    /* Same per-slot sequence as the LatencyTracer ring */
+    uint64_t index = m_slowHead.fetch_add(1, memory_order_relaxed);
+    SlowCall &call = m_slowCalls[index & (OTAI_API_SLOW_LOG_SIZE - 1)];
+
+    call.sequence.store(index * 2 + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    call.type = type;
+    call.op = op;
+    call.slot = slot;
+    call.us = us;
+    call.status = status;
+    call.timestamp = LatencyTracer::now();
+
+    call.sequence.store(index * 2 + 2, memory_order_release);
+}
+
+static const char *g_otaiApiOpNames[OTAI_API_OP_MAX] = { "create", "remove", "set", "get" };
+
+static string getCallName(otai_object_type_t type, OtaiApiOp op, size_t slot)
+{
+    string name = string(otai_metadata_get_object_type_name(type)) + "|" + g_otaiApiOpNames[op];
+
+    if (slot == OTAI_API_STATS_NO_ATTR)
+    {
+        return name;
+    }
+
+    if (slot == OTAI_API_STATS_OTHER_ATTR)
+    {
+        return name + "|other";
+    }
+
+    auto meta = otai_metadata_get_attr_metadata(type, static_cast<otai_attr_id_t>(slot));
+    if (meta == NULL)
+    {
+        return name + "|" + to_string(slot);
+    }
+
+    return name + "|" + meta->attridkebabname;
+}
+
+void OtaiApiStats::getStats(vector<FieldValueTuple> &fvs) const
+{
+    for (size_t type = 0; type < OTAI_OBJECT_TYPE_MAX; type++)
+    {
+        for (size_t op = 0; op < OTAI_API_OP_MAX; op++)
+        {
+            for (size_t slot = 0; slot < OTAI_API_STATS_SLOTS; slot++)
+            {
+                Counters *counters = m_counters[type][op][slot].load(memory_order_acquire);
+                if (counters == NULL)
+                {
+                    continue;
+                }
+
+                fvs.emplace_back(getCallName(static_cast<otai_object_type_t>(type), static_cast<OtaiApiOp>(op), slot),
+                                 counters->latency.toString() +
+                                 ",errors=" + to_string(counters->errors.load(memory_order_relaxed)));
+            }
+        }
+    }
+}
+
+/* The slow calls of the log, oldest first, a record being overwritten is skipped */
+void OtaiApiStats::getSlowCalls(vector<FieldValueTuple> &fvs) const
+{
+    uint64_t head = m_slowHead.load(memory_order_acquire);
+    uint64_t start = head > OTAI_API_SLOW_LOG_SIZE ? head - OTAI_API_SLOW_LOG_SIZE : 0;
+
+    for (uint64_t index = start; index < head; index++)
+    {
+        const SlowCall &call = m_slowCalls[index & (OTAI_API_SLOW_LOG_SIZE - 1)];
+
+        uint64_t sequence = call.sequence.load(memory_order_acquire);
+        if (sequence != index * 2 + 2)
+        {
+            continue;
+        }
+
+        otai_object_type_t type = call.type;
+        OtaiApiOp op = call.op;
+        size_t slot = call.slot;
+        uint64_t us = call.us;
+        otai_status_t status = call.status;
+        uint64_t timestamp = call.timestamp;
+
+        atomic_thread_fence(memory_order_acquire);
+        if (call.sequence.load(memory_order_relaxed) != sequence)
+        {
+            continue;
+        }
+
+        fvs.emplace_back(getCallName(type, op, slot),
+                         "timestamp-us=" + to_string(timestamp) +
+                         ",duration-us=" + to_string(us) +
+                         ",status=" + to_string(status));
+    }
+}
+
+/*
+ * Wrappers of the functions of the API tables, the original tables are kept
+ * and the global API pointers are pointed to timed copies.
+ */
+#define OTAI_API_WRAPPERS(obj, type)                                                            \
+    static otai_##obj##_api_t *g_##obj##_api_orig;                                              \
+    static otai_##obj##_api_t g_##obj##_api_timed;                                              \
+                                                                                                \
+    static otai_status_t timed_create_##obj(otai_object_id_t *oid, otai_object_id_t linecard_id,\
+                                            uint32_t attr_count, const otai_attribute_t *attr_list) \
+    {                                                                                           \
+        OtaiApiCall call(type, OTAI_API_OP_CREATE, OTAI_API_STATS_NO_ATTR);                     \
+        return call.done(g_##obj##_api_orig->create_##obj(oid, linecard_id, attr_count, attr_list)); \
+    }                                                                                           \
+                                                                                                \
+    static otai_status_t timed_remove_##obj(otai_object_id_t oid)                              \
+    {                                                                                           \
+        OtaiApiCall call(type, OTAI_API_OP_REMOVE, OTAI_API_STATS_NO_ATTR);                     \
+        return call.done(g_##obj##_api_orig->remove_##obj(oid));                                \
+    }                                                                                           \
+                                                                                                \
+    static otai_status_t timed_set_##obj##_attribute(otai_object_id_t oid,                     \
+                                                     const otai_attribute_t *attr)              \
+    {                                                                                           \
+        OtaiApiCall call(type, OTAI_API_OP_SET, OtaiApiStats::getSlot(attr->id));               \
+        return call.done(g_##obj##_api_orig->set_##obj##_attribute(oid, attr));                 \
+    }                                                                                           \
+                                                                                                \
+    static otai_status_t timed_get_##obj##_attribute(otai_object_id_t oid, uint32_t attr_count,\
+                                                     otai_attribute_t *attr_list)               \
+    {                                                                                           \
+        OtaiApiCall call(type, OTAI_API_OP_GET, attr_count == 1 ?                               \
+                         OtaiApiStats::getSlot(attr_list[0].id) : OTAI_API_STATS_NO_ATTR);      \
+        return call.done(g_##obj##_api_orig->get_##obj##_attribute(oid, attr_count, attr_list)); \
+    }
+
+#define OTAI_API_WRAP(obj)                                                                      \
+    do {                                                                                        \
+        g_##obj##_api_orig = otai_##obj##_api;                                                  \
+        g_##obj##_api_timed = *otai_##obj##_api;                                                \
+        g_##obj##_api_timed.create_##obj = timed_create_##obj;                                  \
+        g_##obj##_api_timed.remove_##obj = timed_remove_##obj;                                  \
+        g_##obj##_api_timed.set_##obj##_attribute = timed_set_##obj##_attribute;                \
+        g_##obj##_api_timed.get_##obj##_attribute = timed_get_##obj##_attribute;                \
+        otai_##obj##_api = &g_##obj##_api_timed;                                                \
+    } while (0)
+
+OTAI_API_WRAPPERS(port, OTAI_OBJECT_TYPE_PORT)
+OTAI_API_WRAPPERS(transceiver, OTAI_OBJECT_TYPE_TRANSCEIVER)
+OTAI_API_WRAPPERS(physicalchannel, OTAI_OBJECT_TYPE_PHYSICALCHANNEL)
+OTAI_API_WRAPPERS(otn, OTAI_OBJECT_TYPE_OTN)
+OTAI_API_WRAPPERS(och, OTAI_OBJECT_TYPE_OCH)
+OTAI_API_WRAPPERS(logicalchannel, OTAI_OBJECT_TYPE_LOGICALCHANNEL)
+OTAI_API_WRAPPERS(lldp, OTAI_OBJECT_TYPE_LLDP)
+OTAI_API_WRAPPERS(assignment, OTAI_OBJECT_TYPE_ASSIGNMENT)
+OTAI_API_WRAPPERS(ethernet, OTAI_OBJECT_TYPE_ETHERNET)
+OTAI_API_WRAPPERS(interface, OTAI_OBJECT_TYPE_INTERFACE)
+OTAI_API_WRAPPERS(oa, OTAI_OBJECT_TYPE_OA)
+OTAI_API_WRAPPERS(osc, OTAI_OBJECT_TYPE_OSC)
+OTAI_API_WRAPPERS(aps, OTAI_OBJECT_TYPE_APS)
+OTAI_API_WRAPPERS(apsport, OTAI_OBJECT_TYPE_APSPORT)
+OTAI_API_WRAPPERS(attenuator, OTAI_OBJECT_TYPE_ATTENUATOR)
+OTAI_API_WRAPPERS(ocm, OTAI_OBJECT_TYPE_OCM)
+OTAI_API_WRAPPERS(otdr, OTAI_OBJECT_TYPE_OTDR)
+
+/* The linecard is created without a linecard id */
+static otai_linecard_api_t *g_linecard_api_orig;
+static otai_linecard_api_t g_linecard_api_timed;
+
+static otai_status_t timed_create_linecard(otai_object_id_t *oid, uint32_t attr_count,
+                                           const otai_attribute_t *attr_list)
+{
+    OtaiApiCall call(OTAI_OBJECT_TYPE_LINECARD, OTAI_API_OP_CREATE, OTAI_API_STATS_NO_ATTR);
+    return call.done(g_linecard_api_orig->create_linecard(oid, attr_count, attr_list));
+}
+
+static otai_status_t timed_remove_linecard(otai_object_id_t oid)
+{
+    OtaiApiCall call(OTAI_OBJECT_TYPE_LINECARD, OTAI_API_OP_REMOVE, OTAI_API_STATS_NO_ATTR);
+    return call.done(g_linecard_api_orig->remove_linecard(oid));
+}
+
+static otai_status_t timed_set_linecard_attribute(otai_object_id_t oid, const otai_attribute_t *attr)
+{
+    OtaiApiCall call(OTAI_OBJECT_TYPE_LINECARD, OTAI_API_OP_SET, OtaiApiStats::getSlot(attr->id));
+    return call.done(g_linecard_api_orig->set_linecard_attribute(oid, attr));
+}
+
+static otai_status_t timed_get_linecard_attribute(otai_object_id_t oid, uint32_t attr_count,
+                                                  otai_attribute_t *attr_list)
+{
+    OtaiApiCall call(OTAI_OBJECT_TYPE_LINECARD, OTAI_API_OP_GET, attr_count == 1 ?
+                     OtaiApiStats::getSlot(attr_list[0].id) : OTAI_API_STATS_NO_ATTR);
+    return call.done(g_linecard_api_orig->get_linecard_attribute(oid, attr_count, attr_list));
+}
+
+void wrapOtaiApi()
+{
+    SWSS_LOG_ENTER();
+
+    OTAI_API_WRAP(linecard);
+    OTAI_API_WRAP(port);
+    OTAI_API_WRAP(transceiver);
+    OTAI_API_WRAP(physicalchannel);
+    OTAI_API_WRAP(otn);
+    OTAI_API_WRAP(och);
+    OTAI_API_WRAP(logicalchannel);
+    OTAI_API_WRAP(lldp);
+    OTAI_API_WRAP(assignment);
+    OTAI_API_WRAP(ethernet);
+    OTAI_API_WRAP(interface);
+    OTAI_API_WRAP(oa);
+    OTAI_API_WRAP(osc);
+    OTAI_API_WRAP(aps);
+    OTAI_API_WRAP(apsport);
+    OTAI_API_WRAP(attenuator);
+    OTAI_API_WRAP(ocm);
+    OTAI_API_WRAP(otdr);
+
+    SWSS_LOG_NOTICE("Wrapped the OTAI API tables to time the calls");
+}
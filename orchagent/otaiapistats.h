@@ -0,0 +1,119 @@
+#pragma once
+
+extern "C" {
+#include "otai.h"
+}
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "table.h"
+#include "latencytracer.h"
+
+/* Attribute ids from this one on, like the custom ones, share a slot */
+#define OTAI_API_STATS_MAX_ATTRS 256
+
+#define OTAI_API_STATS_OTHER_ATTR OTAI_API_STATS_MAX_ATTRS
+
+/* Slot of the calls without a single attribute: create, remove, bulk get */
+#define OTAI_API_STATS_NO_ATTR (OTAI_API_STATS_MAX_ATTRS + 1)
+
+#define OTAI_API_STATS_SLOTS (OTAI_API_STATS_MAX_ATTRS + 2)
+
+/* Size of the log of the slow calls, a power of two */
+#define OTAI_API_SLOW_LOG_SIZE 256
+
+#define DEFAULT_OTAI_API_SLOW_CALL_MS 100
+
+enum OtaiApiOp
+{
+    OTAI_API_OP_CREATE,
+    OTAI_API_OP_REMOVE,
+    OTAI_API_OP_SET,
+    OTAI_API_OP_GET,
+    OTAI_API_OP_MAX,
+};
+
+// OtaiApiStats times every call of the OTAI API tables. Each call is a
+// synchronous otairedis round trip, the stats tell which object types and
+// attributes are slow on the line card.
+//
+// initOtaiApi() replaces the API tables by copies whose create, remove, set
+// and get functions are wrappers timing the call of the original function,
+// so every caller is covered without changes. The latencies and error counts
+// are kept per object type, operation and attribute id in histograms
+// allocated on first use, and the calls slower than the threshold are kept
+// in a ring of OTAI_API_SLOW_LOG_SIZE records. Both are updated with atomics
+// only and read without a lock.
+class OtaiApiStats
+{
+public:
+    static OtaiApiStats &getInstance();
+
+    void setSlowThreshold(uint64_t ms) { m_slowThresholdUs = ms * 1000; }
+
+    void record(otai_object_type_t type, OtaiApiOp op, size_t slot,
+                uint64_t us, otai_status_t status);
+
+    void getStats(std::vector<swss::FieldValueTuple> &fvs) const;
+
+    void getSlowCalls(std::vector<swss::FieldValueTuple> &fvs) const;
+
+    static size_t getSlot(otai_attr_id_t attr_id);
+
+private:
+    OtaiApiStats() = default;
+
+    struct Counters
+    {
+        LatencyHistogram latency;
+        std::atomic<uint64_t> errors = { 0 };
+    };
+
+    struct SlowCall
+    {
+        std::atomic<uint64_t> sequence = { 0 };
+        otai_object_type_t type;
+        OtaiApiOp op;
+        size_t slot;
+        uint64_t us;
+        otai_status_t status;
+        uint64_t timestamp;
+    };
+
+    std::atomic<Counters *> m_counters[OTAI_OBJECT_TYPE_MAX][OTAI_API_OP_MAX][OTAI_API_STATS_SLOTS] = {};
+
+    std::atomic<uint64_t> m_slowThresholdUs = { DEFAULT_OTAI_API_SLOW_CALL_MS * 1000 };
+    std::atomic<uint64_t> m_slowHead = { 0 };
+    SlowCall m_slowCalls[OTAI_API_SLOW_LOG_SIZE];
+};
+
+// Times one OTAI call, see the wrappers in otaiapistats.cpp.
+class OtaiApiCall
+{
+public:
+    OtaiApiCall(otai_object_type_t type, OtaiApiOp op, size_t slot) :
+        m_type(type), m_op(op), m_slot(slot), m_start(std::chrono::steady_clock::now())
+    {
+    }
+
+    otai_status_t done(otai_status_t status)
+    {
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - m_start).count();
+
+        OtaiApiStats::getInstance().record(m_type, m_op, m_slot, static_cast<uint64_t>(us), status);
+
+        return status;
+    }
+
+private:
+    otai_object_type_t m_type;
+    OtaiApiOp m_op;
+    size_t m_slot;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+void wrapOtaiApi();
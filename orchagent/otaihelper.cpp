@@ -19,6 +19,7 @@ extern "C" {
 #include "otai_serialize.h"
 #include "otaihelper.h"
 #include "orch.h"
+#include "otaiapistats.h"
 
 using namespace std;
 using namespace swss;
@@ -136,6 +137,8 @@ void initOtaiApi()
     otai_api_query(OTAI_API_OCM,                    (void **)&otai_ocm_api);
     otai_api_query(OTAI_API_OTDR,                   (void **)&otai_otdr_api);
 
+    wrapOtaiApi();
+
     otai_log_set(OTAI_API_LINECARD,                 OTAI_LOG_LEVEL_WARN);
     otai_log_set(OTAI_API_PORT,                     OTAI_LOG_LEVEL_WARN);
     otai_log_set(OTAI_API_TRANSCEIVER,              OTAI_LOG_LEVEL_WARN);
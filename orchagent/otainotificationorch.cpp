@@ -0,0 +1,179 @@
+/**
+ * Copyright (c) 2023 Alibaba Group Holding Limited
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABILITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ */
+
+#include <inttypes.h>
+
+#include "otainotificationorch.h"
+#include "notifications.h"
+#include "ocmorch.h"
+#include "orchfsm.h"
+#include "logger.h"
+#include "otai_serialize.h"
+
+using namespace std;
+using namespace swss;
+
+extern OcmOrch *gOcmOrch;
+
+OtaiNotificationOrch::OtaiNotificationOrch(DBConnector *db) :
+    Orch(vector<TableConnector>()),
+    m_ocmReply(new NotificationProducer(db, OT_OCM_REPLY))
+{
+    SWSS_LOG_ENTER();
+
+    m_event = new SelectableEvent();
+    auto executor = new ExecutableEvent(m_event, this, "OTAI_NOTIFICATION");
+    Orch::addExecutor(executor);
+}
+
+void OtaiNotificationOrch::enqueue(const OtaiNotification &notification)
+{
+    bool is_state_change = (notification.type == OTAI_NOTIFICATION_LINECARD_STATE_CHANGE);
+
+    /* Keep the order, a status in the slot is newer than the ones in the ring */
+    bool pushed = !(is_state_change && m_pendingLinecardStatus.load() != OTAI_NOTIFICATION_NO_STATUS) &&
+                  m_ring.push(notification);
+
+    if (!pushed && is_state_change)
+    {
+        m_pendingLinecardStatus.store(notification.status);
+        m_coalesced++;
+        m_event->notify();
+        return;
+    }
+
+    if (!pushed)
+    {
+        m_dropped++;
+        return;
+    }
+
+    m_event->notify();
+
+    uint64_t ns = static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(
+        chrono::steady_clock::now() - notification.enqueued).count());
+
+    m_enqueued++;
+    m_callbackNsTotal += ns;
+
+    uint64_t max = m_callbackNsMax.load();
+    while (ns > max && !m_callbackNsMax.compare_exchange_weak(max, ns))
+    {
+    }
+}
+
+void OtaiNotificationOrch::doTask(SelectableEvent &event)
+{
+    SWSS_LOG_ENTER();
+
+    OtaiNotification notification;
+
+    while (m_ring.pop(notification))
+    {
+        uint64_t us = static_cast<uint64_t>(chrono::duration_cast<chrono::microseconds>(
+            chrono::steady_clock::now() - notification.enqueued).count());
+
+        m_handled++;
+        m_queueDelayUsTotal += us;
+        m_queueDelayUsMax = max(m_queueDelayUsMax, us);
+
+        switch (notification.type)
+        {
+        case OTAI_NOTIFICATION_LINECARD_STATE_CHANGE:
+            handleLinecardStateChange(notification);
+            break;
+        case OTAI_NOTIFICATION_OCM_SPECTRUM_POWER:
+            handleOcmSpectrumPower(notification);
+            break;
+        default:
+            SWSS_LOG_ERROR("Unknown notification type %d", notification.type);
+            break;
+        }
+    }
+
+    int64_t status = m_pendingLinecardStatus.exchange(OTAI_NOTIFICATION_NO_STATUS);
+    if (status != OTAI_NOTIFICATION_NO_STATUS)
+    {
+        notification.type = OTAI_NOTIFICATION_LINECARD_STATE_CHANGE;
+        notification.status = static_cast<int32_t>(status);
+
+        SWSS_LOG_NOTICE("Handling the coalesced linecard state change");
+        handleLinecardStateChange(notification);
+    }
+}
+
+void OtaiNotificationOrch::handleLinecardStateChange(const OtaiNotification &notification)
+{
+    SWSS_LOG_ENTER();
+
+    SWSS_LOG_NOTICE("linecard state change oper_status=%d", notification.status);
+
+    if (notification.status == OTAI_OPER_STATUS_ACTIVE)
+    {
+        OrchFSM::setState(ORCH_STATE_WORK);
+
+        onLinecardActive();
+    }
+    else if (notification.status == OTAI_OPER_STATUS_INACTIVE)
+    {
+        OrchFSM::setState(ORCH_STATE_PAUSE);
+    }
+}
+
+void OtaiNotificationOrch::handleOcmSpectrumPower(const OtaiNotification &notification)
+{
+    SWSS_LOG_ENTER();
+
+    string key;
+
+    if (gOcmOrch == NULL || !gOcmOrch->getObjectKey(notification.object_id, key))
+    {
+        SWSS_LOG_WARN("Unknown ocm 0x%" PRIx64, notification.object_id);
+        return;
+    }
+
+    SWSS_LOG_DEBUG("orch receive ocm notification, %s", key.c_str());
+
+    std::string op("SUCCESS");
+    std::vector<swss::FieldValueTuple> values;
+    std::string request_id;
+
+    /* No scan of this OCM is outstanding, nobody waits for the reply */
+    if (!gOcmOrch->takeScanRequestId(key, request_id))
+    {
+        SWSS_LOG_INFO("Ignore ocm notification without scan, %s", key.c_str());
+        return;
+    }
+
+    values.emplace_back("request-id", request_id);
+
+    m_ocmReply->send(op, key, values);
+}
+
+void OtaiNotificationOrch::getStats(vector<FieldValueTuple> &fvs)
+{
+    uint64_t enqueued = m_enqueued.load();
+
+    fvs.emplace_back("enqueued", to_string(enqueued));
+    fvs.emplace_back("dropped", to_string(m_dropped.load()));
+    fvs.emplace_back("coalesced", to_string(m_coalesced.load()));
+    fvs.emplace_back("handled", to_string(m_handled));
+    fvs.emplace_back("callback-avg-ns", to_string(enqueued ? m_callbackNsTotal.load() / enqueued : 0));
+    fvs.emplace_back("callback-max-ns", to_string(m_callbackNsMax.load()));
+    fvs.emplace_back("queue-delay-avg-us", to_string(m_handled ? m_queueDelayUsTotal / m_handled : 0));
+    fvs.emplace_back("queue-delay-max-us", to_string(m_queueDelayUsMax));
+}
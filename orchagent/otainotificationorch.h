@@ -0,0 +1,82 @@
+#pragma once
+
+#include <atomic>
+#include <climits>
+#include <chrono>
+#include <memory>
+
+#include "orch.h"
+#include "event.h"
+#include "notificationproducer.h"
+#include "notificationring.h"
+
+extern "C" {
+#include "otai.h"
+}
+
+#define OTAI_NOTIFICATION_RING_SIZE 1024
+
+/* No linecard state change is waiting in m_pendingLinecardStatus */
+#define OTAI_NOTIFICATION_NO_STATUS INT64_MIN
+
+typedef enum _OtaiNotificationType_E
+{
+    OTAI_NOTIFICATION_LINECARD_STATE_CHANGE = 0,
+    OTAI_NOTIFICATION_OCM_SPECTRUM_POWER,
+} OtaiNotificationType_E;
+
+struct OtaiNotification
+{
+    OtaiNotificationType_E type;
+    otai_object_id_t linecard_id;
+    otai_object_id_t object_id;
+    int32_t status;
+    std::chrono::steady_clock::time_point enqueued;
+};
+
+/*
+ * OtaiNotificationOrch hands the OTAI notifications over from the OTAI
+ * notification threads to the orchagent event loop. The callbacks only push
+ * an OtaiNotification into a lock-free ring and signal an eventfd, the
+ * notifications are handled by doTask(SelectableEvent&) in the event loop.
+ *
+ * A linecard state change must never be lost. When the ring is full, it is
+ * kept in an atomic slot holding the latest status instead, and the later
+ * state changes overwrite the slot until the event loop has taken it. The
+ * slot is checked after each drain of the ring.
+ */
+class OtaiNotificationOrch : public Orch
+{
+public:
+    OtaiNotificationOrch(swss::DBConnector *db);
+
+    /* Called from the OTAI notification threads */
+    void enqueue(const OtaiNotification &notification);
+
+    void getStats(std::vector<swss::FieldValueTuple> &fvs);
+
+private:
+    void doTask(Consumer &consumer) { }
+    void doTask(swss::SelectableEvent &event);
+
+    void handleLinecardStateChange(const OtaiNotification &notification);
+    void handleOcmSpectrumPower(const OtaiNotification &notification);
+
+    NotificationRing<OtaiNotification, OTAI_NOTIFICATION_RING_SIZE> m_ring;
+    swss::SelectableEvent *m_event;
+
+    std::unique_ptr<swss::NotificationProducer> m_ocmReply;
+
+    /* Updated by the notification threads */
+    std::atomic<uint64_t> m_enqueued = { 0 };
+    std::atomic<uint64_t> m_dropped = { 0 };
+    std::atomic<uint64_t> m_coalesced = { 0 };
+    std::atomic<int64_t> m_pendingLinecardStatus = { OTAI_NOTIFICATION_NO_STATUS };
+    std::atomic<uint64_t> m_callbackNsTotal = { 0 };
+    std::atomic<uint64_t> m_callbackNsMax = { 0 };
+
+    /* Updated by the event loop */
+    uint64_t m_handled = 0;
+    uint64_t m_queueDelayUsTotal = 0;
+    uint64_t m_queueDelayUsMax = 0;
+};
@@ -16,6 +16,7 @@
  *
  */
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <string>
@@ -34,6 +35,9 @@
 #include "notificationproducer.h"
 #include "orchfsm.h"
 #include "notifications.h"
+#include "resultpublisher.h"
+#include "dbconnectorpool.h"
+#include "latencytracer.h"
 
 using namespace std;
 using namespace swss;
@@ -41,6 +45,9 @@ using namespace swss;
 extern LinecardOrch *gLinecardOrch;
 extern FlexCounterOrch *gFlexCounterOrch;
 extern otai_object_id_t gLinecardId;
+extern ResultPublisher *gResultPublisher;
+extern uint32_t gPresenceHoldTimeMs;
+extern bool gWarmStart;
 
 void OtaiObjectOrch::localDataInit(DBConnector* db,
                                   otai_object_type_t obj_type,
@@ -49,13 +56,20 @@ void OtaiObjectOrch::localDataInit(DBConnector* db,
     SWSS_LOG_ENTER();
 
     m_objectName = otai_metadata_get_object_type_name(obj_type);
-    m_stateDb = shared_ptr<DBConnector>(new DBConnector("STATE_DB", 0));
-    m_countersDb = shared_ptr<DBConnector>(new DBConnector("COUNTERS_DB", 0));
+    m_stateDb = DBConnectorPool::getConnector("STATE_DB");
+    m_countersDb = DBConnectorPool::getConnector("COUNTERS_DB");
     m_vid2NameTable = unique_ptr<Table>(new Table(m_countersDb.get(), "VID2NAME"));
 
     m_count = 0;
 
-    for (auto i : cfg_attrs)
+    addAttrDescs(cfg_attrs);
+}
+
+void OtaiObjectOrch::addAttrDescs(const vector<otai_attr_id_t> &attr_ids)
+{
+    SWSS_LOG_ENTER();
+
+    for (auto i : attr_ids)
     {
         auto meta = otai_metadata_get_attr_metadata(m_objectType, i);
         if (meta == NULL)
@@ -63,26 +77,163 @@ void OtaiObjectOrch::localDataInit(DBConnector* db,
             SWSS_LOG_ERROR("invalid attr, object=%s, attr=%d", m_objectName.c_str(), i);
             continue;
         }
- 
-        if (meta->ismandatoryoncreate == true)
-        {
-            m_mandatoryAttrs[meta->attridkebabname] = i;
-        }
 
-        if (meta->iscreateonly == true)
-        {
-            m_createonlyAttrs[meta->attridkebabname] = i;
-        }
-        else if (meta->iscreateandset == true || meta->issetonly == true)
+        OtaiAttrDesc desc;
+        desc.name = meta->attridkebabname;
+        desc.id = i;
+        desc.meta = meta;
+        desc.mandatory = meta->ismandatoryoncreate;
+        desc.createonly = meta->iscreateonly;
+        desc.createandset = !meta->iscreateonly && (meta->iscreateandset || meta->issetonly);
+        desc.irrecoverable = !meta->isrecoverable;
+        desc.readonly = meta->isreadonly;
+
+        auto it = lower_bound(m_attrDescs.begin(), m_attrDescs.end(), desc.name,
+            [](const OtaiAttrDesc &d, const string &name) { return d.name < name; });
+        if (it != m_attrDescs.end() && it->name == desc.name)
         {
-            m_createandsetAttrs[meta->attridkebabname] = i;
+            *it = desc;
+            continue;
         }
+        m_attrDescs.insert(it, desc);
+    }
+}
 
-        if (meta->isrecoverable == false)
-        {
-            m_irrecoverableAttrs[meta->attridkebabname] = i;
-        }
+const OtaiAttrDesc *OtaiObjectOrch::getAttrDesc(const string &field) const
+{
+    auto it = lower_bound(m_attrDescs.begin(), m_attrDescs.end(), field,
+        [](const OtaiAttrDesc &d, const string &name) { return d.name < name; });
+    if (it == m_attrDescs.end() || it->name != field)
+    {
+        return NULL;
+    }
+
+    return &*it;
+}
+
+bool OtaiObjectOrch::isAttrApplied(otai_object_id_t oid, otai_attr_id_t attr_id, const string &value) const
+{
+    auto obj = m_appliedAttrs.find(oid);
+    if (obj == m_appliedAttrs.end())
+    {
+        return false;
+    }
+
+    auto it = lower_bound(obj->second.begin(), obj->second.end(), attr_id,
+        [](const pair<otai_attr_id_t, string> &a, otai_attr_id_t id) { return a.first < id; });
+
+    return it != obj->second.end() && it->first == attr_id && it->second == value;
+}
+
+void OtaiObjectOrch::setAppliedAttr(otai_object_id_t oid, otai_attr_id_t attr_id, const string &value)
+{
+    auto &applied = m_appliedAttrs[oid];
+
+    auto it = lower_bound(applied.begin(), applied.end(), attr_id,
+        [](const pair<otai_attr_id_t, string> &a, otai_attr_id_t id) { return a.first < id; });
+    if (it != applied.end() && it->first == attr_id)
+    {
+        it->second = value;
+        return;
     }
+    applied.insert(it, make_pair(attr_id, value));
+}
+
+void OtaiObjectOrch::clearAppliedAttr(otai_object_id_t oid, otai_attr_id_t attr_id)
+{
+    auto obj = m_appliedAttrs.find(oid);
+    if (obj == m_appliedAttrs.end())
+    {
+        return;
+    }
+
+    auto it = lower_bound(obj->second.begin(), obj->second.end(), attr_id,
+        [](const pair<otai_attr_id_t, string> &a, otai_attr_id_t id) { return a.first < id; });
+    if (it != obj->second.end() && it->first == attr_id)
+    {
+        obj->second.erase(it);
+    }
+}
+
+void OtaiObjectOrch::clearAppliedAttrs(otai_object_id_t oid)
+{
+    m_appliedAttrs.erase(oid);
+}
+
+OtaiObjectRecord *OtaiObjectOrch::getObject(const string &key)
+{
+    auto it = m_key2slot.find(key);
+    if (it == m_key2slot.end())
+    {
+        return NULL;
+    }
+
+    return &m_objects[it->second];
+}
+
+OtaiObjectRecord &OtaiObjectOrch::addObject(const string &key)
+{
+    auto it = m_key2slot.find(key);
+    if (it != m_key2slot.end())
+    {
+        return m_objects[it->second];
+    }
+
+    m_key2slot[key] = m_objects.size();
+    m_objects.emplace_back();
+    m_objects.back().key = key;
+
+    return m_objects.back();
+}
+
+bool OtaiObjectOrch::getObjectId(const string &key, otai_object_id_t &oid)
+{
+    OtaiObjectRecord *object = getObject(key);
+    if (object == NULL || object->oid == OTAI_NULL_OBJECT_ID)
+    {
+        return false;
+    }
+
+    oid = object->oid;
+
+    return true;
+}
+
+void OtaiObjectOrch::setObjectId(const string &key, otai_object_id_t oid)
+{
+    OtaiObjectRecord &object = addObject(key);
+
+    if (object.oid == OTAI_NULL_OBJECT_ID && oid != OTAI_NULL_OBJECT_ID)
+    {
+        m_createdCount++;
+    }
+    else if (object.oid != OTAI_NULL_OBJECT_ID && oid == OTAI_NULL_OBJECT_ID)
+    {
+        m_createdCount--;
+    }
+
+    if (object.oid != OTAI_NULL_OBJECT_ID)
+    {
+        m_oid2slot.erase(object.oid);
+    }
+    if (oid != OTAI_NULL_OBJECT_ID)
+    {
+        m_oid2slot[oid] = m_key2slot[key];
+    }
+    object.oid = oid;
+}
+
+bool OtaiObjectOrch::getObjectKey(otai_object_id_t oid, string &key) const
+{
+    auto it = m_oid2slot.find(oid);
+    if (it == m_oid2slot.end())
+    {
+        return false;
+    }
+
+    key = m_objects[it->second].key;
+
+    return true;
 }
 
 OtaiObjectOrch::OtaiObjectOrch(DBConnector* db,
@@ -105,6 +256,20 @@ OtaiObjectOrch::OtaiObjectOrch(DBConnector* db,
     SWSS_LOG_ENTER();
 
     localDataInit(db, obj_type, cfg_attrs);
+
+    /* Presence changes come from the STATE_DB tables */
+    for (auto &connector : connectors)
+    {
+        if (connector.first->getDbName() == "STATE_DB" && gPresenceHoldTimeMs != 0)
+        {
+            auto interval = timespec { .tv_sec = gPresenceHoldTimeMs / 1000,
+                                       .tv_nsec = (gPresenceHoldTimeMs % 1000) * 1000000 };
+            m_presenceTimer = new SelectableTimer(interval);
+            auto executor = new ExecutableTimer(m_presenceTimer, this, "PRESENCE_HOLD");
+            Orch::addExecutor(executor);
+            break;
+        }
+    }
 }
 
 OtaiObjectOrch::OtaiObjectOrch(DBConnector *db,
@@ -155,14 +320,12 @@ void OtaiObjectOrch::doTask(NotificationConsumer& consumer)
 
     consumer.pop(op, data, values);
 
-    if (m_key2oid.find(data) == m_key2oid.end())
+    if (!getObjectId(data, oid))
     {
         SWSS_LOG_ERROR("Failed to get oid, key=%s|%s", m_objectName.c_str(), data.c_str());
         goto error;
     }
 
-    oid = m_key2oid[data];
-
     if (op == "set")
     {
         for (unsigned i = 0; i < values.size(); i++)
@@ -170,7 +333,8 @@ void OtaiObjectOrch::doTask(NotificationConsumer& consumer)
             string &value = fvValue(values[i]);
             string &field = fvField(values[i]);
 
-            if (m_irrecoverableAttrs.find(field) == m_irrecoverableAttrs.end())
+            auto desc = getAttrDesc(field);
+            if (desc == NULL || !desc->irrecoverable)
             {
                 SWSS_LOG_ERROR("Cannot use redis-channel to set recoverable attr, %s",
                                field.c_str());
@@ -218,17 +382,19 @@ error:
     return;
 }
 
-bool OtaiObjectOrch::createOtaiObject(const string &key)
+void OtaiObjectOrch::buildCreateAttrs(const string &key, vector<otai_attribute_t> &attrs)
 {
     SWSS_LOG_ENTER();
 
-    otai_status_t status;
     otai_attribute_t attr;
-    vector<otai_attribute_t> attrs;
-    otai_object_id_t oid;
 
-    map<string, string> &createonly_attrs = m_key2createonlyAttrs[key];
-    for (auto fv: createonly_attrs)
+    OtaiObjectRecord *object = getObject(key);
+    if (object == NULL)
+    {
+        return;
+    }
+
+    for (auto fv: object->createonlyAttrs)
     {
         if (translateOtaiObjectAttr(fv.first, fv.second, attr) == false)
         {
@@ -240,50 +406,377 @@ bool OtaiObjectOrch::createOtaiObject(const string &key)
     }
 
     addExtraAttrsOnCreate(attrs);
+}
 
-    status = m_createFunc(&oid, gLinecardId, static_cast<uint32_t>(attrs.size()), attrs.data());
-    if (status != OTAI_STATUS_SUCCESS)
+void OtaiObjectOrch::initBulkTables()
+{
+    SWSS_LOG_ENTER();
+
+    if (m_countersPipeline)
     {
-        SWSS_LOG_ERROR("Failed to create %s|%s, rv=%d", m_objectName.c_str(), key.c_str(), status);
-        return false;
+        return;
     }
-    SWSS_LOG_NOTICE("Create %s|%s oid:%" PRIx64, m_objectName.c_str(), key.c_str(), oid);
 
-    m_key2oid[key] = oid;
+    m_countersPipeline = DBConnectorPool::getPipeline("COUNTERS_DB", "bulk-create");
+    m_bulkNameMapTable = unique_ptr<Table>(
+        new Table(m_countersPipeline, m_nameMapTable->getTableName(), true));
+    m_bulkVid2NameTable = unique_ptr<Table>(
+        new Table(m_countersPipeline, m_vid2NameTable->getTableName(), true));
+
+    m_statePipeline = DBConnectorPool::getPipeline("STATE_DB", "bulk-create");
+    m_bulkStateTable = unique_ptr<Table>(
+        new Table(m_statePipeline, m_stateTable->getTableName(), true));
+}
+
+/*
+ * Create a batch of objects. The attribute lists of all objects are built
+ * before the first create call, and the STATE_DB, name-map and VID2NAME
+ * entries of the created objects are written through buffered tables and
+ * flushed once for the whole batch, before their flex counters are set.
+ */
+bool OtaiObjectOrch::createOtaiObjects(const vector<string> &keys)
+{
+    SWSS_LOG_ENTER();
+
+    bool rv = true;
+    vector<vector<otai_attribute_t>> key2attrs(keys.size());
+    vector<otai_object_id_t> oids(keys.size(), OTAI_NULL_OBJECT_ID);
 
-    if (!setOtaiObjectAttrs(key, m_key2createandsetAttrs[key]))
+    for (size_t i = 0; i < keys.size(); i++)
     {
-        SWSS_LOG_ERROR("Failed to set fields, %s", key.c_str());
+        buildCreateAttrs(keys[i], key2attrs[i]);
     }
 
-    if (!syncStateTable(oid, key))
+    for (size_t i = 0; i < keys.size(); i++)
     {
-        SWSS_LOG_ERROR("Failed to get object info, %s", key.c_str());
+        const string &key = keys[i];
+        vector<otai_attribute_t> &attrs = key2attrs[i];
+
+        otai_status_t status = m_createFunc(&oids[i], gLinecardId,
+                                            static_cast<uint32_t>(attrs.size()), attrs.data());
+        if (status != OTAI_STATUS_SUCCESS)
+        {
+            SWSS_LOG_ERROR("Failed to create %s|%s, rv=%d", m_objectName.c_str(), key.c_str(), status);
+            oids[i] = OTAI_NULL_OBJECT_ID;
+            rv = false;
+            continue;
+        }
+        SWSS_LOG_NOTICE("Create %s|%s oid:%" PRIx64, m_objectName.c_str(), key.c_str(), oids[i]);
+
+        setObjectId(key, oids[i]);
+
+        /* Create-only attributes are not needed once the object exists */
+        map<string, string>().swap(getObject(key)->createonlyAttrs);
     }
 
-    FieldValueTuple tuple(otai_serialize_object_id(oid), key);
-    vector<FieldValueTuple> fields;
-    fields.push_back(tuple);
-    m_nameMapTable->set("", fields);
+    initBulkTables();
 
-    m_vid2NameTable->set("", fields);
+    vector<FieldValueTuple> names;
 
-    setFlexCounter(oid, attrs);
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        const string &key = keys[i];
 
-    SWSS_LOG_NOTICE("Initialized %s", key.c_str());
+        if (oids[i] == OTAI_NULL_OBJECT_ID)
+        {
+            continue;
+        }
 
-    return true;
+        if (!setOtaiObjectAttrs(key, getObject(key)->createandsetAttrs))
+        {
+            SWSS_LOG_ERROR("Failed to set fields, %s", key.c_str());
+        }
+
+        if (!syncStateTable(oids[i], key, m_bulkStateTable.get()))
+        {
+            SWSS_LOG_ERROR("Failed to get object info, %s", key.c_str());
+        }
+
+        names.push_back(FieldValueTuple(otai_serialize_object_id(oids[i]), key));
+    }
+
+    if (!names.empty())
+    {
+        m_bulkNameMapTable->set("", names);
+        m_bulkVid2NameTable->set("", names);
+    }
+    m_statePipeline->flush();
+    m_countersPipeline->flush();
+
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        if (oids[i] == OTAI_NULL_OBJECT_ID)
+        {
+            continue;
+        }
+
+        setFlexCounter(oids[i], key2attrs[i]);
+
+        SWSS_LOG_NOTICE("Initialized %s", keys[i].c_str());
+    }
+
+    return rv;
+}
+
+/*
+ * Warm start: restore the oid of every object of the previous run from the
+ * name map and seed the applied attributes from the STATE_DB entry of the
+ * object, before the consumers are refilled from APPL_DB. A configured
+ * attribute which matches the restored state is then not set again. Values
+ * are compared as strings, an attribute reported in another format than
+ * the configured one is simply set again.
+ */
+bool OtaiObjectOrch::bake()
+{
+    SWSS_LOG_ENTER();
+
+    vector<FieldValueTuple> names;
+
+    if (m_nameMapTable)
+    {
+        m_nameMapTable->get("", names);
+    }
+
+    for (auto &name : names)
+    {
+        otai_object_id_t oid;
+        const string &key = fvValue(name);
+
+        try
+        {
+            otai_deserialize_object_id(fvField(name), oid);
+        }
+        catch (...)
+        {
+            SWSS_LOG_ERROR("Invalid oid %s of %s|%s", fvField(name).c_str(),
+                           m_objectName.c_str(), key.c_str());
+            continue;
+        }
+
+        if (oid == OTAI_NULL_OBJECT_ID || getObject(key) != NULL)
+        {
+            continue;
+        }
+
+        /* The name map may be shared with another orch, e.g. transceivers and physical channels */
+        if (otai_object_type_query(oid) != m_objectType)
+        {
+            continue;
+        }
+
+        setObjectId(key, oid);
+        getObject(key)->restored = true;
+        m_restoredCount++;
+        m_reconcilePendingCount++;
+
+        vector<FieldValueTuple> fvs;
+        m_stateTable->get(key, fvs);
+
+        for (auto &fv : fvs)
+        {
+            auto desc = getAttrDesc(fvField(fv));
+            if (desc != NULL && desc->createandset && !desc->irrecoverable)
+            {
+                setAppliedAttr(oid, desc->id, fvValue(fv));
+            }
+        }
+    }
+
+    if (m_restoredCount != 0)
+    {
+        SWSS_LOG_NOTICE("Restored %u %s objects", m_restoredCount, m_objectName.c_str());
+    }
+
+    return Orch::bake();
+}
+
+/*
+ * Reconcile an object restored by bake() with its configuration. The object
+ * is not created again, only the attributes which differ from the restored
+ * state are set, and its flex counters are registered again so that the
+ * reconciling flex counter managers keep them.
+ */
+void OtaiObjectOrch::reconcileOtaiObject(OtaiObjectRecord &object)
+{
+    SWSS_LOG_ENTER();
+
+    uint64_t elided = m_elidedSetCount;
+    uint64_t applied = m_appliedSetCount;
+
+    if (!setOtaiObjectAttrs(object.key, object.createandsetAttrs))
+    {
+        SWSS_LOG_ERROR("Failed to set fields, %s", object.key.c_str());
+    }
+
+    syncStateTable(object.oid, object.key);
+
+    vector<otai_attribute_t> attrs;
+    setFlexCounter(object.oid, attrs);
+
+    object.restored = false;
+    m_reconcilePendingCount--;
+    m_reconciledCount++;
+
+    /* The create call and the sets of the unchanged attributes */
+    m_warmAvoidedCalls += 1 + (m_elidedSetCount - elided);
+    m_warmReissuedSets += m_appliedSetCount - applied;
+
+    SWSS_LOG_INFO("Reconciled %s|%s, %" PRIu64 " sets issued",
+                  m_objectName.c_str(), object.key.c_str(), m_appliedSetCount - applied);
+}
+
+/*
+ * The objects restored by bake() are not valid, e.g. the linecard came back
+ * with another oid. Forget them with their applied attributes, the orch
+ * then creates its objects as on a cold start.
+ */
+void OtaiObjectOrch::abortWarmStart()
+{
+    SWSS_LOG_ENTER();
+
+    set<string> keys;
+
+    for (auto &object : m_objects)
+    {
+        if (!object.restored || otai_object_type_query(object.oid) != m_objectType)
+        {
+            continue;
+        }
+
+        string oid = otai_serialize_object_id(object.oid);
+
+        clearAppliedAttrs(object.oid);
+        m_nameMapTable->hdel("", oid);
+        m_vid2NameTable->hdel("", oid);
+
+        m_createdCount--;
+        m_reconcilePendingCount--;
+        keys.insert(object.key);
+    }
+
+    dropObjects(keys);
+
+    if (m_restoredCount != 0)
+    {
+        SWSS_LOG_NOTICE("Dropped %u restored %s objects", m_restoredCount, m_objectName.c_str());
+    }
+
+    m_restoredCount = 0;
+    m_reconciledCount = 0;
+    m_warmAvoidedCalls = 0;
+    m_warmReissuedSets = 0;
+}
+
+/*
+ * Remove the objects restored by bake() which are not configured anymore,
+ * called once all the configured objects are created or reconciled.
+ */
+void OtaiObjectOrch::removeStaleObjects()
+{
+    SWSS_LOG_ENTER();
+
+    set<string> keys;
+
+    for (auto &object : m_objects)
+    {
+        if (!object.restored || otai_object_type_query(object.oid) != m_objectType)
+        {
+            continue;
+        }
+
+        SWSS_LOG_NOTICE("Removing stale %s|%s, oid 0x%" PRIx64,
+                        m_objectName.c_str(), object.key.c_str(), object.oid);
+
+        if (m_removeFunc != NULL)
+        {
+            otai_status_t status = m_removeFunc(object.oid);
+            if (status != OTAI_STATUS_SUCCESS)
+            {
+                SWSS_LOG_ERROR("Failed to remove stale %s|%s, rv:%d",
+                               m_objectName.c_str(), object.key.c_str(), status);
+            }
+        }
+
+        string oid = otai_serialize_object_id(object.oid);
+
+        clearAppliedAttrs(object.oid);
+        m_nameMapTable->hdel("", oid);
+        m_vid2NameTable->hdel("", oid);
+        m_stateTable->del(object.key);
+        setAuxiliaryFields(object.key, vector<FieldValueTuple>());
+
+        m_createdCount--;
+        m_reconcilePendingCount--;
+        keys.insert(object.key);
+    }
+
+    dropObjects(keys);
+}
+
+/* Erase the records of keys and renumber the slots of the other objects */
+void OtaiObjectOrch::dropObjects(const set<string> &keys)
+{
+    if (keys.empty())
+    {
+        return;
+    }
+
+    vector<OtaiObjectRecord> objects;
+    set<size_t> pending_presence;
+
+    m_key2slot.clear();
+    m_oid2slot.clear();
+
+    for (size_t slot = 0; slot < m_objects.size(); slot++)
+    {
+        OtaiObjectRecord &object = m_objects[slot];
+        if (keys.find(object.key) != keys.end())
+        {
+            continue;
+        }
+
+        if (m_pendingPresence.find(slot) != m_pendingPresence.end())
+        {
+            pending_presence.insert(objects.size());
+        }
+
+        m_key2slot[object.key] = objects.size();
+        if (object.oid != OTAI_NULL_OBJECT_ID)
+        {
+            m_oid2slot[object.oid] = objects.size();
+        }
+        objects.push_back(move(object));
+    }
+
+    m_objects.swap(objects);
+    m_pendingPresence.swap(pending_presence);
 }
 
 void OtaiObjectOrch::publishOperationResult(string channel, otai_status_t status_code, string message) 
 {
-    swss::NotificationProducer notifications(m_stateDb.get(), channel);
     std::vector<swss::FieldValueTuple> entry;
-    auto sent_clients = notifications.send(to_string(status_code), message, entry);
-    SWSS_LOG_NOTICE("publishresult %d, %s to %ld client on channel %s", 
-            status_code, message.c_str(), sent_clients, channel.c_str());
+    publishOperationResult(channel, status_code, message, entry);
 }
 
+void OtaiObjectOrch::publishOperationResult(string channel, otai_status_t status_code, string message,
+                                            vector<FieldValueTuple> &values)
+{
+    gResultPublisher->publish(channel, to_string(status_code), message, values);
+    SWSS_LOG_NOTICE("publishresult %d, %s on channel %s", 
+            status_code, message.c_str(), channel.c_str());
+}
+
+/*
+ * Set the fields of one object. All fields are translated before the first
+ * set is issued, the cached fields are written to STATE_DB in one HSET, and
+ * besides the per-field results on "<field>-<operation-id>", one aggregated
+ * result listing the status of every field is published on "<operation-id>".
+ * The per-field results are skipped in summary mode. Nothing is published
+ * when the caller passes no operation id.
+ *
+ * A value already applied is not set again, its field is still reported as
+ * a success so that northbound callers get a result for every field.
+ */
 bool OtaiObjectOrch::setOtaiObjectAttrs(const string& key, map<string, string>& field_values, string operation_id)
 {
     SWSS_LOG_ENTER();
@@ -296,33 +789,103 @@ bool OtaiObjectOrch::setOtaiObjectAttrs(const string& key, map<string, string>&
         return false;
     }
 
-    if (m_key2oid.find(key) == m_key2oid.end())
+    otai_object_id_t oid;
+    if (!getObjectId(key, oid))
     {
         SWSS_LOG_ERROR("Failed to get oid, key=%s|%s", m_objectName.c_str(), key.c_str());
         return false;
     }
 
-    string error_msg;
-    otai_status_t status = OTAI_STATUS_SUCCESS;
+    vector<otai_attribute_t> attrs(field_values.size());
+    vector<otai_status_t> statuses(field_values.size(), OTAI_STATUS_SUCCESS);
+    vector<const OtaiAttrDesc *> descs(field_values.size(), NULL);
+    vector<bool> elided(field_values.size(), false);
+    size_t i = 0;
 
-    for (auto fv : field_values)
+    for (auto &fv : field_values)
     {
-        string channel = fv.first + "-" + operation_id;
+        auto desc = getAttrDesc(fv.first);
+        descs[i] = desc;
+
+        if (desc == NULL || !desc->createandset)
+        {
+            SWSS_LOG_ERROR("Unsupported attr, %s|%s", m_objectName.c_str(), fv.first.c_str());
+            statuses[i] = OTAI_STATUS_FAILURE;
+        }
+        else if (!desc->irrecoverable && isAttrApplied(oid, desc->id, fv.second))
+        {
+            elided[i] = true;
+        }
+        else if (translateOtaiObjectAttr(*desc, fv.second, attrs[i]) == false)
+        {
+            SWSS_LOG_ERROR("Failed to translate attr, %s|%s",
+                           m_objectName.c_str(), fv.first.c_str());
+            statuses[i] = OTAI_STATUS_FAILURE;
+        }
+        i++;
+    }
+
+    otai_status_t result = OTAI_STATUS_SUCCESS;
+    vector<FieldValueTuple> cached_fvs;
+    vector<FieldValueTuple> field_results;
+    i = 0;
+
+    if (!operation_id.empty())
+    {
+        LatencyTracer::getInstance().mark(operation_id, LATENCY_STAGE_OTAI_START);
+    }
+
+    for (auto &fv : field_values)
+    {
+        string error_msg;
 
         SWSS_LOG_NOTICE("set field=%s value=%s", fv.first.c_str(), fv.second.c_str());
 
-        status = setOtaiObjectAttr(m_key2oid[key], fv.first, fv.second);
-        if (status != OTAI_STATUS_SUCCESS)
+        if (elided[i])
+        {
+            SWSS_LOG_INFO("Skip setting %s|%s %s, value %s is already applied",
+                m_objectName.c_str(),
+                key.c_str(),
+                fv.first.c_str(),
+                fv.second.c_str());
+
+            m_elidedSetCount++;
+
+            if (!operation_id.empty())
+            {
+                if (!gResultPublisher->isSummaryMode())
+                {
+                    error_msg = key + " " + fv.first + " " + fv.second + " already applied";
+                    publishOperationResult(fv.first + "-" + operation_id, statuses[i], error_msg);
+                }
+                field_results.push_back(FieldValueTuple(fv.first, to_string(statuses[i])));
+            }
+            i++;
+            continue;
+        }
+
+        if (statuses[i] == OTAI_STATUS_SUCCESS)
+        {
+            statuses[i] = m_setFunc(oid, &attrs[i]);
+        }
+
+        if (statuses[i] != OTAI_STATUS_SUCCESS)
         {
             SWSS_LOG_ERROR("Failed to set %s|%s %s to %s, status=%d",
                 m_objectName.c_str(),
                 key.c_str(),
                 fv.first.c_str(),
                 fv.second.c_str(),
-                status);
+                statuses[i]);
 
             rv = false;
+            result = statuses[i];
             error_msg = "Failed to set " + key + " " + fv.first + " to " + fv.second;
+
+            if (descs[i] != NULL)
+            {
+                clearAppliedAttr(oid, descs[i]->id);
+            }
         }
         else
         {
@@ -332,16 +895,44 @@ bool OtaiObjectOrch::setOtaiObjectAttrs(const string& key, map<string, string>&
                 fv.first.c_str(),
                 fv.second.c_str());
 
+            m_appliedSetCount++;
+            if (!descs[i]->irrecoverable)
+            {
+                setAppliedAttr(oid, descs[i]->id, fv.second);
+            }
+
             if (m_needToCache.find(fv.first) != m_needToCache.end())
             {
-                vector<FieldValueTuple> fvs;
-                fvs.push_back(fv);
-                m_stateTable->set(key, fvs);
+                cached_fvs.push_back(fv);
             }
             error_msg = "Set " + key + " " + fv.first + " to " + fv.second;
         }
 
-        publishOperationResult(channel, status, error_msg);
+        if (!operation_id.empty())
+        {
+            if (!gResultPublisher->isSummaryMode())
+            {
+                publishOperationResult(fv.first + "-" + operation_id, statuses[i], error_msg);
+            }
+            field_results.push_back(FieldValueTuple(fv.first, to_string(statuses[i])));
+        }
+        i++;
+    }
+
+    if (!operation_id.empty())
+    {
+        LatencyTracer::getInstance().mark(operation_id, LATENCY_STAGE_OTAI_END);
+    }
+
+    if (!cached_fvs.empty())
+    {
+        m_stateTable->set(key, cached_fvs);
+    }
+
+    if (!operation_id.empty() && !field_results.empty())
+    {
+        string message = (rv ? "Set " : "Failed to set ") + key;
+        publishOperationResult(operation_id, result, message, field_results);
     }
 
     return rv;
@@ -352,34 +943,31 @@ bool OtaiObjectOrch::translateOtaiObjectAttr(
     _In_ const string &value,
     _Out_ otai_attribute_t &attr)
 {
-    if (m_createandsetAttrs.find(field) != m_createandsetAttrs.end())
-    {
-        attr.id = m_createandsetAttrs[field];
-    }
-    else if (m_createonlyAttrs.find(field) != m_createonlyAttrs.end())
-    {
-        attr.id = m_createonlyAttrs[field];
-    }
-    else
+    auto desc = getAttrDesc(field);
+    if (desc == NULL || (!desc->createandset && !desc->createonly))
     {
         SWSS_LOG_ERROR("Unrecognized attr, %s|%s", m_objectName.c_str(), field.c_str());
         return false;
     }
-    
-    auto meta = otai_metadata_get_attr_metadata(m_objectType, attr.id);
-    if (meta == NULL)
-    {
-        SWSS_LOG_THROW("Unable to get %s metadata, attr=%d", m_objectName.c_str(), attr.id);
-    }
+
+    return translateOtaiObjectAttr(*desc, value, attr);
+}
+
+bool OtaiObjectOrch::translateOtaiObjectAttr(
+    _In_ const OtaiAttrDesc &desc,
+    _In_ const string &value,
+    _Out_ otai_attribute_t &attr)
+{
+    attr.id = desc.id;
 
     try
     {
-        otai_deserialize_attr_value(value, *meta, attr);
+        otai_deserialize_attr_value(value, *desc.meta, attr);
     }
     catch (...)
     {
         SWSS_LOG_ERROR("Unrecongnized attr value, %s|%s|%s",
-                       m_objectName.c_str(), field.c_str(), value.c_str());
+                       m_objectName.c_str(), desc.name.c_str(), value.c_str());
         return false;
     }
 
@@ -396,15 +984,14 @@ otai_status_t OtaiObjectOrch::setOtaiObjectAttr(
     otai_status_t status;
     otai_attribute_t attr;
 
-    if (m_createandsetAttrs.find(field) == m_createandsetAttrs.end())
+    auto desc = getAttrDesc(field);
+    if (desc == NULL || !desc->createandset)
     {
         SWSS_LOG_ERROR("Unsupported attr, %s|%s", m_objectName.c_str(), field.c_str());
         return OTAI_STATUS_FAILURE;
     }
 
-    attr.id = m_createandsetAttrs[field];
-
-    if (translateOtaiObjectAttr(field, value, attr) == false)
+    if (translateOtaiObjectAttr(*desc, value, attr) == false)
     {
         SWSS_LOG_ERROR("Failed to translate attr, %s|%s",
                        m_objectName.c_str(), field.c_str());
@@ -431,12 +1018,14 @@ otai_status_t OtaiObjectOrch::getOtaiObjectAttr(otai_object_id_t oid, const stri
 
     otai_status_t status;
     otai_attribute_t attr;
-    if (m_readonlyAttrs.find(field) == m_readonlyAttrs.end())
+
+    auto desc = getAttrDesc(field);
+    if (desc == NULL || !desc->readonly)
     {
         SWSS_LOG_ERROR("Unsupported attr, %s|%s", m_objectName.c_str(), field.c_str());
         return OTAI_STATUS_FAILURE;
     }
-    attr.id = m_readonlyAttrs[field];
+    attr.id = desc->id;
 
     status = m_getFunc(oid, 1, &attr);
     if (status != OTAI_STATUS_SUCCESS)
@@ -445,16 +1034,10 @@ otai_status_t OtaiObjectOrch::getOtaiObjectAttr(otai_object_id_t oid, const stri
                        m_objectName.c_str(), field.c_str(), status);
         return status;
     }
-    auto meta = otai_metadata_get_attr_metadata(m_objectType, attr.id);
-    if (meta == NULL)
-    {   
-        SWSS_LOG_ERROR("Unable to get %s metadata, attr=%d", m_objectName.c_str(), attr.id);
-        return OTAI_STATUS_FAILURE; 
-    }
 
     try
     {
-        value = otai_serialize_attr_value(*meta, attr, false, true);
+        value = otai_serialize_attr_value(*desc->meta, attr, false, true);
     }
     catch (...)
     {
@@ -468,20 +1051,26 @@ otai_status_t OtaiObjectOrch::getOtaiObjectAttr(otai_object_id_t oid, const stri
     return OTAI_STATUS_SUCCESS;
 }
 
-bool OtaiObjectOrch::syncStateTable(otai_object_id_t oid, const string &key)
+bool OtaiObjectOrch::syncStateTable(otai_object_id_t oid, const string &key, Table *table)
 {
     SWSS_LOG_ENTER();
 
     vector<FieldValueTuple> fvs;
 
-    if (m_key2auxiliaryFvs.find(key) != m_key2auxiliaryFvs.end())
+    if (table == nullptr)
     {
-        for (auto &fv : m_key2auxiliaryFvs[key])
+        table = m_stateTable.get();
+    }
+
+    OtaiObjectRecord *object = getObject(key);
+    if (object != NULL)
+    {
+        for (auto &fv : object->auxiliaryFvs)
         {
             fvs.push_back(fv);
         }
     }
-    m_stateTable->set(key, fvs);
+    table->set(key, fvs);
 
     return true;
 }
@@ -554,13 +1143,17 @@ void OtaiObjectOrch::doTask(Consumer &consumer)
                 {
                     operation_id = fvValue(i);
                 }
-                else if (m_createonlyAttrs.find(fvField(i)) != m_createonlyAttrs.end())
+                else
                 {
-                    createonly_attrs[fvField(i)] = fvValue(i);
-                }
-                else if (m_createandsetAttrs.find(fvField(i)) != m_createandsetAttrs.end())
-                {
-                    createandset_attrs[fvField(i)] = fvValue(i);
+                    auto desc = getAttrDesc(fvField(i));
+                    if (desc != NULL && desc->createonly)
+                    {
+                        createonly_attrs[fvField(i)] = fvValue(i);
+                    }
+                    else if (desc != NULL && desc->createandset)
+                    {
+                        createandset_attrs[fvField(i)] = fvValue(i);
+                    }
                 }
 
                 if (m_auxiliaryFields.find(fvField(i)) != m_auxiliaryFields.end())
@@ -571,10 +1164,19 @@ void OtaiObjectOrch::doTask(Consumer &consumer)
 
             if (index != -1)
             {
-                m_keys.insert(key);
-                m_key2createandsetAttrs[key] = createandset_attrs;
-                m_key2createonlyAttrs[key] = createonly_attrs;
-                m_key2auxiliaryFvs[key] = auxiliary_fv;
+                OtaiObjectRecord &object = addObject(key);
+                object.createandsetAttrs = createandset_attrs;
+                if (object.oid == OTAI_NULL_OBJECT_ID)
+                {
+                    object.createonlyAttrs = createonly_attrs;
+                }
+                object.auxiliaryFvs = auxiliary_fv;
+                setAuxiliaryFields(key, object.auxiliaryFvs);
+
+                if (object.restored)
+                {
+                    reconcileOtaiObject(object);
+                }
             }
 
             it = consumer.m_toSync.erase(it);
@@ -584,23 +1186,37 @@ void OtaiObjectOrch::doTask(Consumer &consumer)
                 continue;
             }
 
-            for (auto k = m_keys.begin(); k != m_keys.end(); k++)
+            vector<string> pending_keys;
+            for (auto &object : m_objects)
             {
-                if (m_key2oid.find(*k) != m_key2oid.end())
+                if (object.oid == OTAI_NULL_OBJECT_ID)
                 {
-                    continue;
+                    pending_keys.push_back(object.key);
                 }
+            }
 
-                if (!createOtaiObject(*k))
-                {
-                    SWSS_LOG_THROW("Failed to create object");
-                }
+            if (!pending_keys.empty() && !createOtaiObjects(pending_keys))
+            {
+                SWSS_LOG_THROW("Failed to create object");
             }
 
-            if (m_count != 0 && m_key2oid.size() == m_count)
+            if (m_count != 0 && m_createdCount - m_reconcilePendingCount == m_count)
             {
                 SWSS_LOG_NOTICE("Finish initialize %s", m_objectName.c_str());
 
+                if (m_restoredCount != 0)
+                {
+                    removeStaleObjects();
+
+
+                    SWSS_LOG_NOTICE("Reconciled %u of %u restored %s objects, "
+                                    "%" PRIu64 " sets issued, %" PRIu64 " OTAI calls avoided",
+                                    m_reconciledCount, m_restoredCount, m_objectName.c_str(),
+                                    m_warmReissuedSets, m_warmAvoidedCalls);
+
+                    gLinecardOrch->addWarmAvoidedCalls(m_warmAvoidedCalls);
+                }
+
                 gLinecardOrch->incConfigNum();
 
                 m_count = 0;
@@ -635,6 +1251,14 @@ void OtaiObjectOrch::doTask(Consumer &consumer)
         else if (op == DEL_COMMAND)
         {
             SWSS_LOG_NOTICE("Deleting %s", key.c_str());
+
+            OtaiObjectRecord *object = getObject(key);
+            if (object != NULL)
+            {
+                object->auxiliaryFvs.clear();
+                setAuxiliaryFields(key, object->auxiliaryFvs);
+            }
+
             it = consumer.m_toSync.erase(it);
         }
         else
@@ -663,7 +1287,8 @@ void OtaiObjectOrch::doStateTask(Consumer &consumer)
         SWSS_LOG_INFO("%s, key = %s, op = %s", m_objectName.c_str(),
                       key.c_str(), op.c_str());
 
-        if (m_key2oid.find(key) == m_key2oid.end())
+        OtaiObjectRecord *object = getObject(key);
+        if (object == NULL || object->oid == OTAI_NULL_OBJECT_ID)
         {
             it = consumer.m_toSync.erase(it);
             continue;
@@ -684,37 +1309,162 @@ void OtaiObjectOrch::doStateTask(Consumer &consumer)
             continue;
         }
 
-        otai_object_id_t id = m_key2oid[key];
+        string last_present = object->pendingPresent.empty() ? object->present : object->pendingPresent;
 
-        string present;
+        if (present_value == last_present)
+        {
+            it = consumer.m_toSync.erase(it);
+            continue;
+        }
+
+        m_presenceChanges++;
 
-        if (m_key2present.find(key) != m_key2present.end())
+        /* The first presence report has no flap to filter */
+        if (m_presenceTimer == NULL || object->present.empty())
         {
-            present = m_key2present[key];
+            applyPresence(*object, present_value);
+            it = consumer.m_toSync.erase(it);
+            continue;
         }
 
-        if (present_value != present)
+        size_t slot = m_key2slot[key];
+
+        if (present_value == object->present)
         {
-            if (present_value == "PRESENT")
+            /* Reverted within the hold time, drop both changes */
+            SWSS_LOG_NOTICE("Suppressed %s flap, key = %s", m_objectName.c_str(), key.c_str());
+            object->pendingPresent.clear();
+            m_pendingPresence.erase(slot);
+            m_presenceSuppressed += 2;
+        }
+        else
+        {
+            if (!object->pendingPresent.empty())
             {
-                SWSS_LOG_NOTICE("setCounterIdList 0x%lx, key = %s", id, key.c_str());
-                vector<otai_attribute_t> attrs;
-                setFlexCounter(id, attrs);
+                m_presenceSuppressed++;
             }
-            else if (present_value == "NOT_PRESENT")
+            object->pendingPresent = present_value;
+            object->presentDeadline = chrono::steady_clock::now() + chrono::milliseconds(gPresenceHoldTimeMs);
+            m_pendingPresence.insert(slot);
+
+            if (!m_presenceTimerRunning)
             {
-                SWSS_LOG_NOTICE("clearCounterIdList 0x%lx, key = %s", id, key.c_str());
-                clearFlexCounter(id, key);
+                auto interval = timespec { .tv_sec = gPresenceHoldTimeMs / 1000,
+                                           .tv_nsec = (gPresenceHoldTimeMs % 1000) * 1000000 };
+                m_presenceTimer->setInterval(interval);
+                m_presenceTimer->start();
+                m_presenceTimerRunning = true;
             }
-
-            doSubobjectStateTask(key, present_value);
-            m_key2present[key] = present_value;
         }
 
         it = consumer.m_toSync.erase(it);
     }
 }
 
+void OtaiObjectOrch::applyPresence(OtaiObjectRecord &object, const string &present)
+{
+    SWSS_LOG_ENTER();
+
+    otai_object_id_t id = object.oid;
+
+    if (present == "PRESENT")
+    {
+        SWSS_LOG_NOTICE("setCounterIdList 0x%lx, key = %s", id, object.key.c_str());
+        vector<otai_attribute_t> attrs;
+        setFlexCounter(id, attrs);
+    }
+    else if (present == "NOT_PRESENT")
+    {
+        SWSS_LOG_NOTICE("clearCounterIdList 0x%lx, key = %s", id, object.key.c_str());
+        clearFlexCounter(id, object.key);
+    }
+
+    /*
+     * The hardware may not keep the applied values across a presence change.
+     * On warm start, the first report is the presence already applied by the
+     * previous run, the values restored by bake() are kept.
+     */
+    if (!object.present.empty() || !gWarmStart)
+    {
+        clearAppliedAttrs(id);
+    }
+
+    doSubobjectStateTask(object.key, present);
+    object.present = present;
+    m_presenceApplied++;
+}
+
+/* Apply the presence changes which have been stable for the hold time */
+void OtaiObjectOrch::doTask(SelectableTimer &timer)
+{
+    SWSS_LOG_ENTER();
+
+    if (&timer != m_presenceTimer)
+    {
+        return;
+    }
+
+    auto now = chrono::steady_clock::now();
+    auto next = chrono::steady_clock::time_point::max();
+
+    auto it = m_pendingPresence.begin();
+    while (it != m_pendingPresence.end())
+    {
+        OtaiObjectRecord &object = m_objects[*it];
+
+        if (object.presentDeadline > now)
+        {
+            next = min(next, object.presentDeadline);
+            it++;
+            continue;
+        }
+
+        if (object.oid != OTAI_NULL_OBJECT_ID && !object.pendingPresent.empty())
+        {
+            applyPresence(object, object.pendingPresent);
+        }
+        object.pendingPresent.clear();
+        it = m_pendingPresence.erase(it);
+    }
+
+    if (m_pendingPresence.empty())
+    {
+        m_presenceTimer->stop();
+        m_presenceTimerRunning = false;
+        return;
+    }
+
+    auto ns = chrono::duration_cast<chrono::nanoseconds>(next - now).count();
+    auto interval = timespec { .tv_sec = static_cast<time_t>(ns / 1000000000),
+                               .tv_nsec = static_cast<long>(ns % 1000000000) };
+    m_presenceTimer->setInterval(interval);
+    m_presenceTimer->reset();
+}
+
+void OtaiObjectOrch::getPresenceStats(vector<FieldValueTuple> &fvs) const
+{
+    fvs.emplace_back(m_objectName,
+                     "changes=" + to_string(m_presenceChanges) +
+                     ",applied=" + to_string(m_presenceApplied) +
+                     ",suppressed=" + to_string(m_presenceSuppressed) +
+                     ",pending=" + to_string(m_pendingPresence.size()));
+}
+
+void OtaiObjectOrch::getWarmRestartStats(vector<FieldValueTuple> &fvs) const
+{
+    if (m_restoredCount == 0)
+    {
+        return;
+    }
+
+    fvs.emplace_back(m_objectName,
+                     "restored=" + to_string(m_restoredCount) +
+                     ",reconciled=" + to_string(m_reconciledCount) +
+                     ",pending=" + to_string(m_reconcilePendingCount) +
+                     ",sets-issued=" + to_string(m_warmReissuedSets) +
+                     ",calls-avoided=" + to_string(m_warmAvoidedCalls));
+}
+
 void OtaiObjectOrch::setSelfProcessAttrs(
         const string &key,
         vector<FieldValueTuple> &auxiliary_fv,
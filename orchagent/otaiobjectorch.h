@@ -4,10 +4,12 @@
 #include <vector>
 #include <map>
 #include <tuple>
+#include <chrono>
 #include "orch.h"
 #include "otaihelper.h"
 #include "notifier.h"
 #include "notificationproducer.h"
+#include "redispipeline.h"
 #include "notifications.h"
 #include "timer.h"
 
@@ -34,6 +36,47 @@ typedef otai_status_t (*GetObjectAttrFunc)(
         uint32_t attr_count,
         otai_attribute_t *attr_list);
 
+/*
+ * Descriptor of one attribute of an object type, built when the orch is
+ * constructed.
+ *
+ * createandset: Attributes that can be modified by OTAI at anytime.
+ * createonly: Attributes that can only be set during creation.
+ * irrecoverable: Attributes like OTAI_LINECARD_ATTR_RESET. These attributes
+ *                are modified by notification channels instead of config table.
+ */
+struct OtaiAttrDesc
+{
+    string name;
+    otai_attr_id_t id;
+    const otai_attr_metadata_t *meta;
+    bool createonly;
+    bool createandset;
+    bool irrecoverable;
+    bool mandatory;
+    bool readonly;
+};
+
+/*
+ * Record of one object, holding its oid, presence state, the attributes
+ * pending for creation and the auxiliary fields handled by the orch itself.
+ * The create-only attributes are released once the object is created.
+ */
+struct OtaiObjectRecord
+{
+    string key;
+    otai_object_id_t oid = OTAI_NULL_OBJECT_ID;
+    string present;
+    /* Presence change held back until presentDeadline, see doStateTask() */
+    string pendingPresent;
+    std::chrono::steady_clock::time_point presentDeadline;
+    map<string, string> createonlyAttrs;
+    map<string, string> createandsetAttrs;
+    vector<FieldValueTuple> auxiliaryFvs;
+    /* Restored on warm start, not reconciled with its configuration yet */
+    bool restored = false;
+};
+
 typedef enum _ConfigState_E
 {
     CONFIG_MISSING = 0,
@@ -73,17 +116,67 @@ public:
                        otai_object_type_t obj_type,
                        const vector<otai_attr_id_t>& cfg_attrs);
 
+    void addAttrDescs(const vector<otai_attr_id_t> &attr_ids);
+
+    const OtaiAttrDesc *getAttrDesc(const string &field) const;
+
+    bool isAttrApplied(otai_object_id_t oid, otai_attr_id_t attr_id, const string &value) const;
+
+    void setAppliedAttr(otai_object_id_t oid, otai_attr_id_t attr_id, const string &value);
+
+    void clearAppliedAttr(otai_object_id_t oid, otai_attr_id_t attr_id);
+
+    void clearAppliedAttrs(otai_object_id_t oid);
+
+    const string &getObjectName() const { return m_objectName; }
+
+    OtaiObjectRecord *getObject(const string &key);
+
+    OtaiObjectRecord &addObject(const string &key);
+
+    bool getObjectId(const string &key, otai_object_id_t &oid);
+
+    void setObjectId(const string &key, otai_object_id_t oid);
+
+    bool getObjectKey(otai_object_id_t oid, string &key) const;
+
+    uint64_t getAppliedSetCount() const { return m_appliedSetCount; }
+
+    uint64_t getElidedSetCount() const { return m_elidedSetCount; }
+
+    bool bake() override;
+
+    void reconcileOtaiObject(OtaiObjectRecord &object);
+
+    void abortWarmStart();
+
+    void removeStaleObjects();
+
+    void getWarmRestartStats(vector<FieldValueTuple> &fvs) const;
+
+    uint64_t getWarmAvoidedCalls() const { return m_warmAvoidedCalls; }
+
     void doTask(Consumer &consumer);
 
     virtual void doTask(NotificationConsumer& consumer);
 
     void doStateTask(Consumer &consumer);
 
-    bool createOtaiObject(const string &key);
+    void doTask(SelectableTimer &timer);
+
+    void applyPresence(OtaiObjectRecord &object, const string &present);
+
+    void getPresenceStats(vector<FieldValueTuple> &fvs) const;
+
+    void initBulkTables();
+
+    void buildCreateAttrs(const string &key, vector<otai_attribute_t> &attrs);
+
+    bool createOtaiObjects(const vector<string> &keys);
 
     virtual void addExtraAttrsOnCreate(vector<otai_attribute_t> &attrs) {};
 
-    bool syncStateTable(otai_object_id_t oid, const string &key);
+    bool syncStateTable(otai_object_id_t oid, const string &key, Table *table = nullptr);
 
     bool setOtaiObjectAttrs(const string &key,
                            map<string, string> &field_values,
@@ -103,12 +196,21 @@ public:
 
     virtual void doSubobjectStateTask(const string &key, const string &present){};
 
-    void publishOperationResult(string operation_id, int status_code, string message);
+    virtual void setAuxiliaryFields(const string &key, const vector<FieldValueTuple> &auxiliary_fv){};
+
+    void publishOperationResult(string channel, otai_status_t status_code, string message);
+
+    void publishOperationResult(string channel, otai_status_t status_code, string message,
+                                vector<FieldValueTuple> &values);
 
     bool translateOtaiObjectAttr(_In_ const string &field,
                                 _In_ const string &value,
                                 _Out_ otai_attribute_t &attr);
 
+    bool translateOtaiObjectAttr(_In_ const OtaiAttrDesc &desc,
+                                _In_ const string &value,
+                                _Out_ otai_attribute_t &attr);
+
 protected:
 
     shared_ptr<DBConnector> m_stateDb;
@@ -123,9 +225,26 @@ protected:
 
     unique_ptr<Table> m_vid2NameTable;
 
+    /*
+     * Buffered tables used by createOtaiObjects() to flush the entries of
+     * a whole batch of objects at once. The "bulk-create" pipelines are
+     * shared by all orchs and flushed before createOtaiObjects() returns,
+     * see DBConnectorPool.
+     */
+
+    RedisPipeline *m_countersPipeline = NULL;
+
+    unique_ptr<Table> m_bulkNameMapTable;
+
+    unique_ptr<Table> m_bulkVid2NameTable;
+
+    RedisPipeline *m_statePipeline = NULL;
+
+    unique_ptr<Table> m_bulkStateTable;
+
     CreateObjectFunc m_createFunc;
 
-    RemoveObjectFunc m_removeFunc;
+    RemoveObjectFunc m_removeFunc = NULL;
 
     SetObjectAttrFunc m_setFunc;
 
@@ -136,45 +255,80 @@ protected:
     string m_objectName;
 
     /*
-     * Attributes that can be modified by OTAI at anytime.
+     * Descriptors of the configurable and readonly attributes, sorted by
+     * kebab name so that a field resolves with a single lookup.
+     */
+
+    vector<OtaiAttrDesc> m_attrDescs;
+
+    /*
+     * Last successfully applied value of the recoverable create-and-set
+     * attributes of each object, sorted by attr id. A set with the same
+     * value is elided.
      */
 
-    map<string, otai_attr_id_t> m_createandsetAttrs;
+    unordered_map<otai_object_id_t, vector<pair<otai_attr_id_t, string>>> m_appliedAttrs;
+
+    uint64_t m_appliedSetCount = 0;
+
+    uint64_t m_elidedSetCount = 0;
+
+    ConfigState_E m_configState = CONFIG_MISSING;
+
+    uint32_t m_count;
 
     /*
-     * Attributes that can only be set during creation.
+     * Objects of the orch, addressed by slot. A slot is assigned when the
+     * key is first configured, the slots are only renumbered when restored
+     * objects are dropped, see dropObjects().
      */
 
-    map<string, otai_attr_id_t> m_createonlyAttrs;
+    vector<OtaiObjectRecord> m_objects;
+
+    unordered_map<string, size_t> m_key2slot;
+
+    unordered_map<otai_object_id_t, size_t> m_oid2slot;
+
+    uint32_t m_createdCount = 0;
 
     /*
-     * Irrecoverable attributes like OTAI_LINECARD_ATTR_RESET.
-     * These attributes are modified by notification channels instead of config table.
+     * Warm start, see bake(). The restored objects are counted in
+     * m_createdCount, the ones still waiting for their configuration in
+     * m_reconcilePendingCount.
      */
 
-    map<string, otai_attr_id_t> m_irrecoverableAttrs;
+    uint32_t m_restoredCount = 0;
 
-    map<string, otai_attr_id_t> m_mandatoryAttrs;
+    uint32_t m_reconcilePendingCount = 0;
 
-    map<string, otai_attr_id_t> m_readonlyAttrs;
+    uint32_t m_reconciledCount = 0;
 
-    ConfigState_E m_configState = CONFIG_MISSING;
+    uint64_t m_warmAvoidedCalls = 0;
 
-    uint32_t m_count;
+    uint64_t m_warmReissuedSets = 0;
+
+    void dropObjects(const set<string> &keys);
+
+    /*
+     * Presence changes are applied once the new value has been stable for
+     * the hold time, so a flapping object costs a single flex counter and
+     * sub-object update. A change reverted within the hold time is
+     * suppressed.
+     */
 
-    set<string> m_keys;
+    SelectableTimer *m_presenceTimer = NULL;
 
-    map<string, otai_object_id_t> m_key2oid;
+    bool m_presenceTimerRunning = false;
 
-    map<string, map<string, string>> m_key2createonlyAttrs;
+    set<size_t> m_pendingPresence;
 
-    map<string, map<string, string>> m_key2createandsetAttrs;
+    uint64_t m_presenceChanges = 0;
 
-    map<string, string> m_key2present;
+    uint64_t m_presenceApplied = 0;
 
-    set<string> m_auxiliaryFields;
+    uint64_t m_presenceSuppressed = 0;
 
-    map<string, vector<FieldValueTuple>> m_key2auxiliaryFvs;
+    set<string> m_auxiliaryFields;
 
     set<string> m_needToCache;
 
@@ -24,7 +24,6 @@ using namespace std;
 using namespace swss;
 
 extern FlexCounterOrch *gFlexCounterOrch;
-extern std::unordered_set<std::string> otdr_counter_ids_status;
 
 vector<otai_attr_id_t> g_otdr_cfg_attrs =
 {
@@ -75,7 +74,7 @@ void OtdrOrch::setFlexCounter(otai_object_id_t id, vector<otai_attribute_t> &att
 {
     SWSS_LOG_ENTER();
  
-    gFlexCounterOrch->getStatusGroup()->setCounterIdList(id, CounterType::OTDR_STATUS, otdr_counter_ids_status);
+    gFlexCounterOrch->setCounterIdList(id, CounterType::OTDR_STATUS);
 }
 
 void OtdrOrch::doTask(swss::NotificationConsumer &consumer)
@@ -103,7 +102,8 @@ void OtdrOrch::doTask(swss::NotificationConsumer &consumer)
         return;
     }
  
-    if (m_key2oid.find(data) == m_key2oid.end())
+    otai_object_id_t oid;
+    if (!getObjectId(data, oid))
     {
         op_ret = "FAILED";
         m_notificationProducer->send(op_ret, data, values);
@@ -113,8 +113,6 @@ void OtdrOrch::doTask(swss::NotificationConsumer &consumer)
  
     bool success = false;
  
-    otai_object_id_t oid = m_key2oid[data];
-
     otai_status_t status;
  
     if (op == "set")
@@ -124,22 +122,16 @@ void OtdrOrch::doTask(swss::NotificationConsumer &consumer)
             std::string &value = fvValue(values[i]);
             std::string &field = fvField(values[i]);
  
-            if (m_irrecoverableAttrs.find(field) == m_irrecoverableAttrs.end())
-            {
-                success = false;
-                break;
-            }
- 
-            if (m_createandsetAttrs.find(field) == m_createandsetAttrs.end())
+            auto desc = getAttrDesc(field);
+            if (desc == NULL || !desc->irrecoverable || !desc->createandset)
             {
                 success = false;
                 break;
             }
  
             otai_attribute_t attr;
-            attr.id = m_createandsetAttrs[field];
  
-            if (translateOtaiObjectAttr(field, value, attr) == false)
+            if (translateOtaiObjectAttr(*desc, value, attr) == false)
             {
                 success = false;
                 break;
@@ -21,9 +21,6 @@
 using namespace std;
 
 extern FlexCounterOrch *gFlexCounterOrch;
-extern std::unordered_set<std::string> otn_counter_ids_counter;
-extern std::unordered_set<std::string> otn_counter_ids_gauge;
-extern std::unordered_set<std::string> otn_counter_ids_status;
 
 vector<otai_attr_id_t> g_otn_cfg_attrs =
 {
@@ -61,15 +58,13 @@ OtnOrch::OtnOrch(DBConnector *db, std::vector<TableConnector>& connectors)
 
 void OtnOrch::setFlexCounter(otai_object_id_t id, vector<otai_attribute_t> &attrs)
 {            
-    gFlexCounterOrch->getCounterGroup()->setCounterIdList(id, CounterType::OTN_COUNTER, otn_counter_ids_counter);
-    gFlexCounterOrch->getGaugeGroup()->setCounterIdList(id, CounterType::OTN_GAUGE, otn_counter_ids_gauge);
-    gFlexCounterOrch->getStatusGroup()->setCounterIdList(id, CounterType::OTN_STATUS, otn_counter_ids_status);
+    gFlexCounterOrch->setCounterIdList(id, CounterType::OTN_COUNTER);
+    gFlexCounterOrch->setCounterIdList(id, CounterType::OTN_GAUGE);
+    gFlexCounterOrch->setCounterIdList(id, CounterType::OTN_STATUS);
 }
 
 void OtnOrch::clearFlexCounter(otai_object_id_t id, string key)
 {
-    gFlexCounterOrch->getCounterGroup()->clearCounterIdList(id);
-    gFlexCounterOrch->getGaugeGroup()->clearCounterIdList(id);
-    gFlexCounterOrch->getStatusGroup()->clearCounterIdList(id);
+    gFlexCounterOrch->clearCounterIdList(id);
 }
 
@@ -23,9 +23,6 @@ using namespace std;
 using namespace swss;
 
 extern FlexCounterOrch *gFlexCounterOrch;
-extern std::unordered_set<std::string> physicalch_counter_ids_counter;
-extern std::unordered_set<std::string> physicalch_counter_ids_gauge;
-extern std::unordered_set<std::string> physicalch_counter_ids_status;
 
 vector<otai_attr_id_t> g_physicalchannel_cfg_attrs =
 {
@@ -54,14 +51,12 @@ PhysicalChannelOrch::PhysicalChannelOrch(DBConnector *db, std::vector<TableConne
 
 void PhysicalChannelOrch::setFlexCounter(otai_object_id_t id, vector<otai_attribute_t> &attrs)
 {
-    gFlexCounterOrch->getCounterGroup()->setCounterIdList(id, CounterType::PHYSICALCH_COUNTER, physicalch_counter_ids_counter);
-    gFlexCounterOrch->getGaugeGroup()->setCounterIdList(id, CounterType::PHYSICALCH_GAUGE, physicalch_counter_ids_gauge);
-    gFlexCounterOrch->getStatusGroup()->setCounterIdList(id, CounterType::PHYSICALCH_STATUS, physicalch_counter_ids_status);
+    gFlexCounterOrch->setCounterIdList(id, CounterType::PHYSICALCH_COUNTER);
+    gFlexCounterOrch->setCounterIdList(id, CounterType::PHYSICALCH_GAUGE);
+    gFlexCounterOrch->setCounterIdList(id, CounterType::PHYSICALCH_STATUS);
 }
 
 void PhysicalChannelOrch::clearFlexCounter(otai_object_id_t id, string key)
 {
-    gFlexCounterOrch->getCounterGroup()->clearCounterIdList(id);
-    gFlexCounterOrch->getGaugeGroup()->clearCounterIdList(id);
-    gFlexCounterOrch->getStatusGroup()->clearCounterIdList(id);
+    gFlexCounterOrch->clearCounterIdList(id);
 }
@@ -27,10 +27,6 @@
 using namespace std;
 
 extern FlexCounterOrch* gFlexCounterOrch;
-extern std::unordered_set<std::string> port_counter_ids_status;
-extern std::unordered_set<std::string> port_counter_ids_gauge;
-extern std::unordered_set<std::string> inport_counter_ids_gauge;
-extern std::unordered_set<std::string> outport_counter_ids_gauge;
 
 vector<otai_attr_id_t> g_port_cfg_attrs =
 {
@@ -93,7 +89,7 @@ void PortOrch::setFlexCounter(otai_object_id_t id, vector<otai_attribute_t> &att
     case OTAI_PORT_TYPE_OLP_PRI_IN:
     case OTAI_PORT_TYPE_OLP_SEC_IN:
     case OTAI_PORT_TYPE_OLP_COM_IN:
-        gFlexCounterOrch->getGaugeGroup()->setCounterIdList(id, CounterType::INPORT_GAUGE, inport_counter_ids_gauge);
+        gFlexCounterOrch->setCounterIdList(id, CounterType::INPORT_GAUGE);
         break;
     case OTAI_PORT_TYPE_LINE_OUT:
     case OTAI_PORT_TYPE_CLIENT_OUT:
@@ -103,13 +99,13 @@ void PortOrch::setFlexCounter(otai_object_id_t id, vector<otai_attribute_t> &att
     case OTAI_PORT_TYPE_OLP_PRI_OUT:
     case OTAI_PORT_TYPE_OLP_SEC_OUT:
     case OTAI_PORT_TYPE_OLP_COM_OUT:
-        gFlexCounterOrch->getGaugeGroup()->setCounterIdList(id, CounterType::OUTPORT_GAUGE, outport_counter_ids_gauge);
+        gFlexCounterOrch->setCounterIdList(id, CounterType::OUTPORT_GAUGE);
         break;
     default:
-        gFlexCounterOrch->getGaugeGroup()->setCounterIdList(id, CounterType::PORT_GAUGE, port_counter_ids_gauge);
+        gFlexCounterOrch->setCounterIdList(id, CounterType::PORT_GAUGE);
         break;
     }
 
-    gFlexCounterOrch->getStatusGroup()->setCounterIdList(id, CounterType::PORT_STATUS, port_counter_ids_status);
+    gFlexCounterOrch->setCounterIdList(id, CounterType::PORT_STATUS);
 }
 
@@ -0,0 +1,82 @@
+/**
+ * Copyright (c) 2023 Alibaba Group Holding Limited
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABILITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ */
+
+#include "resultpublisher.h"
+#include "logger.h"
+#include "json.h"
+#include "rediscommand.h"
+#include "latencytracer.h"
+
+using namespace std;
+using namespace swss;
+
+ResultPublisher::ResultPublisher(DBConnector *db, bool summary_mode) :
+    m_pipeline(new RedisPipeline(db)),
+    m_summaryMode(summary_mode)
+{
+    SWSS_LOG_ENTER();
+}
+
+void ResultPublisher::publish(const string &channel,
+                              const string &op,
+                              const string &data,
+                              vector<FieldValueTuple> &values)
+{
+    SWSS_LOG_ENTER();
+
+    /* Same message as NotificationProducer::send() */
+    vector<FieldValueTuple> message = values;
+    message.insert(message.begin(), FieldValueTuple(op, data));
+
+    RedisCommand command;
+    command.format("PUBLISH %s %s", channel.c_str(), JSon::buildJson(message).c_str());
+    m_pipeline->push(command, REDIS_REPLY_INTEGER);
+
+    m_pending++;
+    m_publishedCount++;
+
+    /*
+     * Ends the trace once sent if the channel is a traced operation-id, the
+     * queued result already keeps the trace from being abandoned.
+     */
+    LatencyTracer::getInstance().mark(channel, LATENCY_STAGE_PUBLISH);
+    m_sentChannels.push_back(channel);
+
+    SWSS_LOG_INFO("Queued result %s, %s on channel %s",
+                  op.c_str(), data.c_str(), channel.c_str());
+}
+
+void ResultPublisher::flush()
+{
+    if (m_pending == 0)
+    {
+        return;
+    }
+
+    m_pipeline->flush();
+
+    for (auto &channel : m_sentChannels)
+    {
+        LatencyTracer::getInstance().finish(channel);
+    }
+    m_sentChannels.clear();
+
+    SWSS_LOG_DEBUG("Flushed %zu results", m_pending);
+
+    m_pending = 0;
+    m_flushCount++;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "dbconnector.h"
+#include "redispipeline.h"
+#include "table.h"
+
+// ResultPublisher publishes the results of northbound operations.
+//
+// Every result is queued as a PUBLISH command on one RedisPipeline, so the
+// results queued during one event loop iteration are sent by a single
+// flush() instead of a round trip per result. The message has the format of
+// swss::NotificationProducer, the subscribers are unchanged.
+//
+// In summary mode the callers publish a single result per operation-id
+// instead of one result per field.
+class ResultPublisher
+{
+public:
+    ResultPublisher(swss::DBConnector *db, bool summary_mode = false);
+
+    ResultPublisher(const ResultPublisher&) = delete;
+    ResultPublisher& operator=(const ResultPublisher&) = delete;
+
+    void publish(const std::string &channel,
+                 const std::string &op,
+                 const std::string &data,
+                 std::vector<swss::FieldValueTuple> &values);
+
+    void flush();
+
+    bool isSummaryMode() const { return m_summaryMode; }
+    void setSummaryMode(bool summary_mode) { m_summaryMode = summary_mode; }
+
+    uint64_t getPublishedCount() const { return m_publishedCount; }
+    uint64_t getFlushCount() const { return m_flushCount; }
+
+private:
+    std::unique_ptr<swss::RedisPipeline> m_pipeline;
+
+    /* Channels of the queued results, the traces end when they are sent */
+    std::vector<std::string> m_sentChannels;
+
+    bool m_summaryMode;
+    size_t m_pending = 0;
+    uint64_t m_publishedCount = 0;
+    uint64_t m_flushCount = 0;
+};
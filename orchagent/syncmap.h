@@ -0,0 +1,225 @@
+#pragma once
+
+#include <iterator>
+#include <list>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "table.h"
+
+// SyncMap stores the pending tasks of a Consumer.
+//
+// Tasks are kept in a list ordered by key, like the std::multimap it
+// replaces, and indexed by key. One key holds at most two tasks: a DEL task
+// followed by a SET task. A new key is inserted before the first task of
+// the next key of the index, and merging a new SET into the pending one
+// costs O(fields) instead of rescanning the pending fields for every
+// incoming field.
+//
+// Iteration and erase follow the std::multimap interface used by the orchs,
+// i.e. it->first is the key, it->second is the KeyOpFieldsValuesTuple and
+// erase(it) returns the iterator following the erased task.
+class SyncMap
+{
+public:
+    typedef std::pair<const std::string, swss::KeyOpFieldsValuesTuple> value_type;
+    typedef std::list<value_type>::iterator iterator;
+    typedef std::list<value_type>::const_iterator const_iterator;
+
+    iterator begin() { return m_tasks.begin(); }
+    iterator end() { return m_tasks.end(); }
+    const_iterator begin() const { return m_tasks.begin(); }
+    const_iterator end() const { return m_tasks.end(); }
+
+    bool empty() const { return m_tasks.empty(); }
+    size_t size() const { return m_tasks.size(); }
+
+    // Returns the first pending task of the key, i.e. the DEL task if any
+    iterator find(const std::string &key)
+    {
+        auto idx = m_index.find(key);
+        if (idx == m_index.end())
+        {
+            return m_tasks.end();
+        }
+
+        return idx->second.del != m_tasks.end() ? idx->second.del : idx->second.set;
+    }
+
+    size_t count(const std::string &key) const
+    {
+        auto idx = m_index.find(key);
+        if (idx == m_index.end())
+        {
+            return 0;
+        }
+
+        return (idx->second.del != m_tasks.end() ? 1 : 0) +
+               (idx->second.set != m_tasks.end() ? 1 : 0);
+    }
+
+    iterator erase(iterator it)
+    {
+        auto idx = m_index.find(it->first);
+        if (idx != m_index.end())
+        {
+            KeyTasks &tasks = idx->second;
+
+            if (tasks.del == it)
+            {
+                tasks.del = m_tasks.end();
+            }
+            else if (tasks.set == it)
+            {
+                tasks.set = m_tasks.end();
+            }
+
+            if (tasks.del == m_tasks.end() && tasks.set == m_tasks.end())
+            {
+                m_index.erase(idx);
+            }
+        }
+
+        return m_tasks.erase(it);
+    }
+
+    size_t erase(const std::string &key)
+    {
+        auto idx = m_index.find(key);
+        if (idx == m_index.end())
+        {
+            return 0;
+        }
+
+        size_t erased = 0;
+        KeyTasks &tasks = idx->second;
+
+        if (tasks.del != m_tasks.end())
+        {
+            m_tasks.erase(tasks.del);
+            erased++;
+        }
+        if (tasks.set != m_tasks.end())
+        {
+            m_tasks.erase(tasks.set);
+            erased++;
+        }
+        m_index.erase(idx);
+
+        return erased;
+    }
+
+    void clear()
+    {
+        m_index.clear();
+        m_tasks.clear();
+    }
+
+    /*
+     * Add a task and collapse it with the pending tasks of the same key:
+     *  - A task for a new key is inserted at its place in key order.
+     *  - A DEL task overwrites all pending tasks of the key.
+     *  - A SET task is inserted after a pending DEL task, or merged into the
+     *    pending SET task. A field already pending is removed and the new
+     *    fields are appended in their order.
+     */
+    void addTask(const swss::KeyOpFieldsValuesTuple &entry)
+    {
+        const std::string &key = kfvKey(entry);
+        const std::string &op = kfvOp(entry);
+
+        auto idx = m_index.find(key);
+        if (idx == m_index.end())
+        {
+            idx = m_index.emplace(key, KeyTasks(m_tasks.end())).first;
+        }
+        else if (op == DEL_COMMAND)
+        {
+            erase(key);
+            idx = m_index.emplace(key, KeyTasks(m_tasks.end())).first;
+        }
+
+        KeyTasks &tasks = idx->second;
+
+        if (op == DEL_COMMAND)
+        {
+            tasks.del = m_tasks.emplace(nextKeyTask(idx), key, entry);
+            return;
+        }
+
+        if (tasks.set == m_tasks.end())
+        {
+            tasks.set = m_tasks.emplace(nextKeyTask(idx), key, entry);
+            return;
+        }
+
+        mergeFields(kfvFieldsValues(tasks.set->second), kfvFieldsValues(entry));
+        kfvOp(tasks.set->second) = op;
+    }
+
+private:
+    struct KeyTasks
+    {
+        explicit KeyTasks(iterator none) : del(none), set(none) {}
+
+        iterator del;
+        iterator set;
+    };
+
+    typedef std::map<std::string, KeyTasks>::iterator index_iterator;
+
+    /* First task of the key following idx, the tasks of idx go before it */
+    iterator nextKeyTask(index_iterator idx)
+    {
+        auto next = std::next(idx);
+        if (next == m_index.end())
+        {
+            return m_tasks.end();
+        }
+
+        return next->second.del != m_tasks.end() ? next->second.del : next->second.set;
+    }
+
+    /*
+     * Same result as erasing each pending field found in new_values and
+     * appending the new one, in one pass over each vector. A field repeated
+     * in new_values keeps its last value, at the place of its last one.
+     */
+    static void mergeFields(std::vector<swss::FieldValueTuple> &values,
+                            const std::vector<swss::FieldValueTuple> &new_values)
+    {
+        std::unordered_map<std::string, size_t> last;
+        last.reserve(new_values.size());
+        for (size_t i = 0; i < new_values.size(); i++)
+        {
+            last[fvField(new_values[i])] = i;
+        }
+
+        std::vector<swss::FieldValueTuple> merged;
+        merged.reserve(values.size() + new_values.size());
+
+        for (auto &fv : values)
+        {
+            if (last.find(fvField(fv)) == last.end())
+            {
+                merged.push_back(std::move(fv));
+            }
+        }
+
+        for (size_t i = 0; i < new_values.size(); i++)
+        {
+            if (last[fvField(new_values[i])] == i)
+            {
+                merged.push_back(new_values[i]);
+            }
+        }
+
+        values.swap(merged);
+    }
+
+    std::list<value_type> m_tasks;
+    std::map<std::string, KeyTasks> m_index;
+};
@@ -16,7 +16,6 @@
  */
 
 #include <iostream>
-#include <sstream>
 #include <string>
 #include "transceiverorch.h"
 #include "flexcounterorch.h"
@@ -24,14 +23,12 @@
 #include "notifier.h"
 #include "notificationproducer.h"
 #include "notifications.h"
+#include "dbconnectorpool.h"
 
 using namespace std;
 using namespace swss;
 
 extern FlexCounterOrch *gFlexCounterOrch;
-extern std::unordered_set<std::string> transceiver_counter_ids_counter;
-extern std::unordered_set<std::string> transceiver_counter_ids_gauge;
-extern std::unordered_set<std::string> transceiver_counter_ids_status;
 
 vector<otai_attr_id_t> g_transceiver_cfg_attrs =
 {
@@ -75,12 +72,13 @@ TransceiverOrch::TransceiverOrch(DBConnector *db, std::vector<TableConnector>& c
     m_upgrade_notification_consumer = new NotificationConsumer(db, "UPGRADE_TRANSCEIVER");
     auto upgrade_notifier = new Notifier(m_upgrade_notification_consumer, this, "UPGRADE_TRANSCEIVER");
     Orch::addExecutor(upgrade_notifier);
-    m_pchTable = std::unique_ptr<Table>(new Table(m_stateDb.get(), STATE_OT_PHYSICALCHANNEL_TABLE_NAME));
-    m_lchTable = std::unique_ptr<Table>(new Table(m_stateDb.get(), STATE_OT_LOGICALCHANNEL_TABLE_NAME));
-    m_ethTable = std::unique_ptr<Table>(new Table(m_stateDb.get(), STATE_OT_ETHERNET_TABLE_NAME));
-    m_otnTable = std::unique_ptr<Table>(new Table(m_stateDb.get(), STATE_OT_OTN_TABLE_NAME));
-    m_ochTable = std::unique_ptr<Table>(new Table(m_stateDb.get(), STATE_OT_OCH_TABLE_NAME));
-    m_intfTable = std::unique_ptr<Table>(new Table(m_stateDb.get(), STATE_OT_INTERFACE_TABLE_NAME));
+    m_subobjectPipeline = DBConnectorPool::getPipeline("STATE_DB", "transceiver-subobject");
+    m_pchTable = std::unique_ptr<Table>(new Table(m_subobjectPipeline, STATE_OT_PHYSICALCHANNEL_TABLE_NAME, true));
+    m_lchTable = std::unique_ptr<Table>(new Table(m_subobjectPipeline, STATE_OT_LOGICALCHANNEL_TABLE_NAME, true));
+    m_ethTable = std::unique_ptr<Table>(new Table(m_subobjectPipeline, STATE_OT_ETHERNET_TABLE_NAME, true));
+    m_otnTable = std::unique_ptr<Table>(new Table(m_subobjectPipeline, STATE_OT_OTN_TABLE_NAME, true));
+    m_ochTable = std::unique_ptr<Table>(new Table(m_subobjectPipeline, STATE_OT_OCH_TABLE_NAME, true));
+    m_intfTable = std::unique_ptr<Table>(new Table(m_subobjectPipeline, STATE_OT_INTERFACE_TABLE_NAME, true));
 
     m_createFunc = otai_transceiver_api->create_transceiver;
     m_removeFunc = otai_transceiver_api->remove_transceiver;
@@ -175,7 +173,7 @@ void TransceiverOrch::doUpgradeTask(NotificationConsumer& consumer)
         }
     }
 
-    if (m_key2oid.find(key) == m_key2oid.end())
+    if (!getObjectId(key, oid))
     {
         SWSS_LOG_ERROR("Failed to find oid");
         data = "FAILED";
@@ -183,8 +181,6 @@ void TransceiverOrch::doUpgradeTask(NotificationConsumer& consumer)
         return;
     }
 
-    oid = m_key2oid[key];
-
     if (op == "download")
     {
         attr.id = OTAI_TRANSCEIVER_ATTR_UPGRADE_DOWNLOAD;
@@ -221,92 +217,101 @@ void TransceiverOrch::doUpgradeTask(NotificationConsumer& consumer)
 
 void tokenize(string const &str, const char delim, vector<string> &out)
 {
-    stringstream ss(str);
-    string s;
-    while (getline(ss, s, delim))
+    size_t start = 0;
+
+    while (start < str.size())
     {
-        out.push_back(s);
+        size_t end = str.find(delim, start);
+        if (end == string::npos)
+        {
+            end = str.size();
+        }
+        if (end > start)
+        {
+            out.push_back(str.substr(start, end - start));
+        }
+        start = end + 1;
     }
 }
 
-void TransceiverOrch::doSubobjectStateTask(const string &key, const string &present)
+void TransceiverOrch::setAuxiliaryFields(const string &key, const vector<FieldValueTuple> &auxiliary_fv)
 {
-    vector<string> pch_keys;
-    vector<string> lch_keys;
-    vector<string> och_keys;
-    vector<string> intf_keys;
-    vector<string> eth_keys;
-    vector<string> otn_keys;
-
-    if (m_key2auxiliaryFvs.find(key) == m_key2auxiliaryFvs.end())
-    {
-        return;
-    }
+    SWSS_LOG_ENTER();
 
-    for (auto fv: m_key2auxiliaryFvs[key])
+    auto &subobjects = m_subobjectKeys[key];
+    subobjects.clear();
+
+    for (auto &fv : auxiliary_fv)
     {
+        Table *table = NULL;
+
         if (fvField(fv) == "physical-channel")
         {
-            tokenize(fvValue(fv), ',', pch_keys);
+            table = m_pchTable.get();
         }
         else if (fvField(fv) == "logical-channel")
         {
-            tokenize(fvValue(fv), ',', lch_keys);
+            table = m_lchTable.get();
         }
         else if (fvField(fv) == "ethernet")
         {
-            tokenize(fvValue(fv), ',', eth_keys);
+            table = m_ethTable.get();
         }
         else if (fvField(fv) == "otn")
         {
-            tokenize(fvValue(fv), ',', otn_keys);
+            table = m_otnTable.get();
         }
         else if (fvField(fv) == "och")
         {
-            tokenize(fvValue(fv), ',', och_keys);
+            table = m_ochTable.get();
         }
         else if (fvField(fv) == "interface")
         {
-            tokenize(fvValue(fv), ',', intf_keys);
+            table = m_intfTable.get();
+        }
+        else
+        {
+            continue;
         }
-    }
 
-    for (auto &pch : pch_keys)
-    {
-        m_pchTable->hset(pch, "present", present);
+        vector<string> keys;
+        tokenize(fvValue(fv), ',', keys);
+        for (auto &k : keys)
+        {
+            subobjects.emplace_back(table, k);
+        }
     }
 
-    for (auto &lch : lch_keys)
+    /* No auxiliary field is left when the transceiver is deleted */
+    if (subobjects.empty())
     {
-        m_lchTable->hset(lch, "present", present);
+        m_subobjectKeys.erase(key);
     }
+}
 
-    for (auto &otn : otn_keys)
-    {
-        m_otnTable->hset(otn, "present", present);
-    }
+void TransceiverOrch::doSubobjectStateTask(const string &key, const string &present)
+{
+    SWSS_LOG_ENTER();
 
-    for (auto &eth : eth_keys)
+    auto it = m_subobjectKeys.find(key);
+    if (it == m_subobjectKeys.end())
     {
-        m_ethTable->hset(eth, "present", present);
+        return;
     }
 
-    for (auto &och : och_keys)
+    for (auto &subobject : it->second)
     {
-        m_ochTable->hset(och, "present", present);
+        subobject.first->hset(subobject.second, "present", present);
     }
 
-    for (auto &intf : intf_keys)
-    {
-        m_intfTable->hset(intf, "present", present);
-    }
+    m_subobjectPipeline->flush();
 }
 
 void TransceiverOrch::setFlexCounter(otai_object_id_t id, vector<otai_attribute_t> &attrs)
 {
-    gFlexCounterOrch->getGaugeGroup()->setCounterIdList(id, CounterType::TRANSCEIVER_GAUGE, transceiver_counter_ids_gauge);
-    gFlexCounterOrch->getCounterGroup()->setCounterIdList(id, CounterType::TRANSCEIVER_COUNTER, transceiver_counter_ids_counter);
-    gFlexCounterOrch->getStatusGroup()->setCounterIdList(id, CounterType::TRANSCEIVER_STATUS, transceiver_counter_ids_status);
+    gFlexCounterOrch->setCounterIdList(id, CounterType::TRANSCEIVER_GAUGE);
+    gFlexCounterOrch->setCounterIdList(id, CounterType::TRANSCEIVER_COUNTER);
+    gFlexCounterOrch->setCounterIdList(id, CounterType::TRANSCEIVER_STATUS);
 }
 
 void TransceiverOrch::clearFlexCounter(otai_object_id_t id, string key)
@@ -314,10 +319,8 @@ void TransceiverOrch::clearFlexCounter(otai_object_id_t id, string key)
     unordered_set<string> present_status = 
         { "OTAI_TRANSCEIVER_ATTR_PRESENT" };
 
-    gFlexCounterOrch->getGaugeGroup()->clearCounterIdList(id);
-    gFlexCounterOrch->getCounterGroup()->clearCounterIdList(id);
-    gFlexCounterOrch->getStatusGroup()->clearCounterIdList(id);
+    gFlexCounterOrch->clearCounterIdList(id);
 
-    gFlexCounterOrch->getStatusGroup()->setCounterIdList(id, CounterType::TRANSCEIVER_STATUS, present_status); 
+    gFlexCounterOrch->setCounterIdList(id, CounterType::TRANSCEIVER_STATUS, present_status); 
 }
 
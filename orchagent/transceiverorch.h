@@ -9,6 +9,7 @@ public:
     void setFlexCounter(otai_object_id_t id, vector<otai_attribute_t> &attrs);
     void clearFlexCounter(otai_object_id_t id, string key);
     void doSubobjectStateTask(const string &key, const string &present);
+    void setAuxiliaryFields(const string &key, const vector<FieldValueTuple> &auxiliary_fv);
 
 private:
     void doTask(NotificationConsumer& consumer);
@@ -16,6 +17,16 @@ private:
     void getUpgradeState(otai_object_id_t oid);
     swss::NotificationConsumer *m_upgrade_notification_consumer;
     swss::DBConnector* m_db;
+
+    /*
+     * The sub-object state tables are buffered on m_subobjectPipeline, the
+     * present field of all sub-objects of a transceiver is written in one
+     * flush. m_subobjectKeys holds the sub-object keys of each transceiver,
+     * parsed when its config arrives and erased when it is deleted. The
+     * pipeline is the "transceiver-subobject" one of DBConnectorPool.
+     */
+    swss::RedisPipeline *m_subobjectPipeline = NULL;
+    std::unordered_map<std::string, std::vector<std::pair<swss::Table *, std::string>>> m_subobjectKeys;
     std::unique_ptr<swss::Table> m_pchTable;
     std::unique_ptr<swss::Table> m_lchTable;
     std::unique_ptr<swss::Table> m_otnTable;